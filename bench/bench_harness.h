@@ -0,0 +1,204 @@
+/*******************************************************************************
+Title           : bench_harness.h
+Created on      : Oct 19, 2026
+Description     : Interface and implementation of the BenchHarness class
+Purpose         : Times small pieces of code many times over and reports the
+                  cost per operation, its spread across samples, and a JSON
+                  record of the run that can be kept to compare runs over time
+*******************************************************************************/
+
+#ifndef SW2_BENCH_HARNESS_H_
+#define SW2_BENCH_HARNESS_H_
+
+#include "../src/Stats/perf_counters.h"
+
+using namespace std;
+
+/** keep(v) makes the compiler believe v is read, so that the work that
+ *  computed it is not optimized away
+ */
+template <class T>
+    inline void keep(const T &value){
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+/** struct BenchResult holds the timing of one benchmark. Every sample runs
+ *  the benchmark body the same number of times; the statistics are over the
+ *  samples' nanoseconds per operation. With counters, counts holds what the
+ *  hardware counters counted over all the samples.
+ */
+struct BenchResult{
+    string name;
+    long ops_per_call;      // operations one call of the body performs
+    long calls_per_sample;
+    vector<double> ns_per_op;
+    double mean, variance, stddev, min, max;
+    bool counted;
+    uint64_t counts[num_Perf_counters];
+
+    double ops_per_second() const{
+        return mean>0?1e9/mean:0;
+    }
+
+    double ipc() const{
+        return counts[cycles_counter]>0?
+               (double)counts[instructions_counter]/counts[cycles_counter]:0;
+    }
+
+    double per_op(Perf_counter counter) const{
+        return (double)counts[counter]/
+               ((double)ns_per_op.size()*calls_per_sample*ops_per_call);
+    }
+};
+
+/** class BenchHarness runs benchmarks and collects their results. A body is
+ *  first called until it has run for the warm-up time, which also sets how
+ *  many calls make up a sample of about the sample time. Then the samples
+ *  are taken.
+ */
+class BenchHarness{
+    public:
+
+    /** BenchHarness(samples,sample_ms,filter,counters) takes samples samples
+     *  of about sample_ms milliseconds of each benchmark whose name contains
+     *  filter. With counters, the hardware counters are read around the
+     *  samples too, where perf_event_open allows it.
+     */
+    explicit BenchHarness(int _samples=10, double _sample_ms=50,
+                          const string &_filter="", bool _counters=false):
+        samples(max(_samples, 2)), sample_ms(_sample_ms), filter(_filter),
+        counters(_counters && PerfCounters::local().available()),
+        counters_asked(_counters){}
+
+    /** run(name,ops,body) times body, which performs ops operations per
+     *  call, and prints a line of the results table on cout
+     */
+    void run(const string &name, long ops, const function<void()> &body){
+        if(name.find(filter)==string::npos)
+            return;
+        if(results.empty())
+            print_header();
+
+        BenchResult r;
+        r.name=name;
+        r.ops_per_call=max(ops, 1L);
+
+        //warm up, doubling the calls until they take a tenth of a sample
+        long calls=1;
+        while(true){
+            double ms=time_calls(body, calls)/1e6;
+            if(ms>=sample_ms/10 || calls>=(1L<<40))
+                break;
+            calls*=2;
+        }
+        double per_call=time_calls(body, calls)/calls;
+        r.calls_per_sample=max(1L, (long)(sample_ms*1e6/max(per_call, 1.0)));
+
+        uint64_t before[num_Perf_counters];
+        r.counted=counters;
+        if(counters)
+            PerfCounters::local().read(before);
+        for(int s=0; s<samples; s++)
+            r.ns_per_op.push_back(time_calls(body, r.calls_per_sample)/
+                                  ((double)r.calls_per_sample*r.ops_per_call));
+        if(counters){
+            PerfCounters::local().read(r.counts);
+            for(int c=0; c<num_Perf_counters; c++)
+                r.counts[c]-=min(before[c], r.counts[c]);
+        }
+        summarize(r);
+        print(r);
+        results.push_back(r);
+    }
+
+    /** write_json(out,context) writes all results as one JSON object, with
+     *  context, a list of "key":value pairs, at its start
+     */
+    void write_json(ostream &out, const string &context) const{
+        out<<"{"<<context<<(context.empty()?"":",")<<"\"samples\":"<<samples
+           <<",\"results\":[";
+        for(size_t i=0; i<results.size(); i++){
+            const BenchResult &r=results[i];
+            out<<(i?",":"")<<"\n{\"name\":\""<<r.name<<"\",\"ops_per_call\":"
+               <<r.ops_per_call<<",\"calls_per_sample\":"<<r.calls_per_sample
+               <<setprecision(6)<<",\"ns_per_op\":"<<r.mean
+               <<",\"ops_per_s\":"<<r.ops_per_second()
+               <<",\"variance_ns2\":"<<r.variance<<",\"stddev_ns\":"<<r.stddev
+               <<",\"min_ns\":"<<r.min<<",\"max_ns\":"<<r.max;
+            if(r.counted){
+                out<<",\"ipc\":"<<r.ipc();
+                for(int c=0; c<num_Perf_counters; c++)
+                    if(PerfCounters::local().has((Perf_counter)c))
+                        out<<",\""<<counter_name((Perf_counter)c)
+                           <<"_per_op\":"<<r.per_op((Perf_counter)c);
+            }
+            out<<"}";
+        }
+        out<<"\n]}\n";
+    }
+
+    const vector<BenchResult> &all_results() const{
+        return results;
+    }
+
+    private:
+
+    int samples;
+    double sample_ms;
+    string filter;
+    bool counters;          // read the counters around the samples
+    bool counters_asked;
+    vector<BenchResult> results;
+
+    //returns the nanoseconds calls calls of body took
+    static double time_calls(const function<void()> &body, long calls){
+        auto start=chrono::steady_clock::now();
+        for(long c=0; c<calls; c++)
+            body();
+        return chrono::duration<double, nano>(chrono::steady_clock::now()-
+                                              start).count();
+    }
+
+    static void summarize(BenchResult &r){
+        const vector<double> &v=r.ns_per_op;
+        r.mean=accumulate(v.begin(), v.end(), 0.0)/v.size();
+        r.variance=0;
+        for(double x:v)
+            r.variance+=(x-r.mean)*(x-r.mean);
+        r.variance/=v.size()-1;
+        r.stddev=sqrt(r.variance);
+        r.min=*min_element(v.begin(), v.end());
+        r.max=*max_element(v.begin(), v.end());
+    }
+
+    void print_header() const{
+        if(counters_asked && !counters)
+            cout<<"hardware counters not available ("
+                <<PerfCounters::local().error()<<")\n";
+        cout<<left<<setw(28)<<"benchmark"<<right<<setw(14)<<"ns/op"
+            <<setw(16)<<"ops/s"<<setw(14)<<"stddev_ns"<<setw(10)<<"cv%";
+        if(counters)
+            cout<<setw(7)<<"IPC"<<setw(12)<<"L1D_miss/op"<<setw(12)
+                <<"LLC_miss/op"<<setw(12)<<"br_miss/op";
+        cout<<"\n";
+    }
+
+    void print(const BenchResult &r) const{
+        cout<<left<<setw(28)<<r.name<<right<<fixed<<setprecision(2)
+            <<setw(14)<<r.mean<<setw(16)<<setprecision(0)<<r.ops_per_second()
+            <<setw(14)<<setprecision(2)<<r.stddev<<setw(10)
+            <<(r.mean>0?100*r.stddev/r.mean:0);
+        if(counters){
+            cout<<setw(7)<<r.ipc();
+            for(Perf_counter c:{l1d_misses_counter, llc_misses_counter,
+                                branch_misses_counter})
+                if(PerfCounters::local().has(c))
+                    cout<<setw(12)<<r.per_op(c);
+                else
+                    cout<<setw(12)<<"-";
+        }
+        cout<<"\n"<<defaultfloat;
+    }
+};
+
+#endif //SW2_BENCH_HARNESS_H_
@@ -0,0 +1,263 @@
+/**
+    census_scaling.cpp
+    @version 1.0 10/19/26
+    Purpose: To time loading and querying synthetic data files of 1, 10 and
+             50 times the size of the census, and to measure the memory the
+             loaded trees take. Each size is loaded in a child process of its
+             own, so that its peak memory is not mixed with the others'.
+    Usage:   nyc_trees_census_scaling [--scales=1,10,50] [--seed=S]
+                                      [--duplicates=R] [--bad-rows=R]
+                                      [--repeats=N] [--dir=DIR] [--keep]
+                                      [--json=FILE]
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/TreeCollection/tree_collection.h"
+#include "../src/Loader/tree_loader.h"
+#include "../src/Generator/census_generator.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+const double NEAR_POINTS[][2]={{40.7831, -73.9712}, {40.6782, -73.9442},
+                               {40.7282, -73.7949}, {40.8448, -73.8648},
+                               {40.5795, -74.1502}};
+const int ZIPCODES[]={10025, 11215, 11375, 10467, 10314};
+const char *SPECIES[]={"london planetree", "pin oak", "ginkgo", "maple"};
+const double NEAR_DISTANCE=0.5;
+const int LOOKUPS=1000;
+
+struct ScaleResult{
+    double scale;
+    long rows;
+    double file_mb, generate_s;
+    bool loaded;
+    long trees;
+    double load_s, near_ms, zip_ms, info_ms, id_ms;
+    double rss_mb, peak_mb;
+};
+
+double elapsed_ms(chrono::steady_clock::time_point start){
+    return chrono::duration<double, milli>(chrono::steady_clock::now()-start)
+           .count();
+}
+
+//returns the resident memory of this process in MB
+double resident_mb(){
+    long pages=0, resident=0;
+    ifstream statm("/proc/self/statm");
+    statm>>pages>>resident;
+    return resident*(double)sysconf(_SC_PAGESIZE)/(1<<20);
+}
+
+/** load_and_query(path,repeats,r) runs in the child process. It loads the
+ *  data file at path and times each kind of query repeats times.
+ */
+void load_and_query(const string &path, int repeats, ScaleResult &r){
+    ifstream in(path);
+    TreeCollection trees;
+    auto start=chrono::steady_clock::now();
+    TreeLoader loader(trees);
+    loader.load(in);
+    r.load_s=elapsed_ms(start)/1000;
+    r.trees=trees.total_tree_count();
+    r.rss_mb=resident_mb();
+
+    //the sizes keep the queries from being optimized away
+    size_t found=0;
+    start=chrono::steady_clock::now();
+    rep(i, repeats)
+        for(auto &p:NEAR_POINTS)
+            found+=trees.get_all_near(p[0], p[1], NEAR_DISTANCE).size();
+    r.near_ms=elapsed_ms(start)/repeats/size(NEAR_POINTS);
+
+    start=chrono::steady_clock::now();
+    rep(i, repeats)
+        for(int zip:ZIPCODES)
+            found+=trees.get_all_in_zipcode(zip).size();
+    r.zip_ms=elapsed_ms(start)/repeats/size(ZIPCODES);
+
+    //tree_info: the matching species and their counts by borough
+    start=chrono::steady_clock::now();
+    rep(i, repeats)
+        for(const char *name:SPECIES)
+            for(const string &s:trees.get_matching_species(name)){
+                boro counts[5];
+                found+=trees.get_counts_of_trees_by_boro(s, counts);
+            }
+    r.info_ms=elapsed_ms(start)/repeats/size(SPECIES);
+
+    mt19937 random(1);
+    start=chrono::steady_clock::now();
+    rep(i, LOOKUPS)
+        found+=trees.tree_by_id(random()%r.rows+1)!=nullptr;
+    r.id_ms=elapsed_ms(start)/LOOKUPS;
+    if(found==0)
+        cerr<<"no trees found by the queries\n";
+}
+
+/** run_scale(r,path,repeats) loads the file in a child process and fills
+ *  in the child's results and peak memory. It returns false if the child
+ *  did not finish, e.g. because it ran out of memory.
+ */
+bool run_scale(ScaleResult &r, const string &path, int repeats){
+    int fds[2];
+    if(pipe(fds)!=0)
+        return false;
+    cout.flush();       //or the child would print it again
+    pid_t child=fork();
+    if(child==0){
+        close(fds[0]);
+        //the bad rows would each print a line
+        int null_fd=open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDERR_FILENO);
+        load_and_query(path, repeats, r);
+        ssize_t n=write(fds[1], &r, sizeof r);
+        _exit(n==(ssize_t)sizeof r?0:1);
+    }
+    close(fds[1]);
+    if(child<0){
+        close(fds[0]);
+        return false;
+    }
+    ScaleResult from_child;
+    bool got=read(fds[0], &from_child, sizeof from_child)==
+             (ssize_t)sizeof from_child;
+    close(fds[0]);
+    int status;
+    struct rusage usage;
+    if(wait4(child, &status, 0, &usage)<0 || !WIFEXITED(status) ||
+       WEXITSTATUS(status)!=0 || !got)
+        return false;
+    r=from_child;
+    r.peak_mb=usage.ru_maxrss/1024.0;
+    return true;
+}
+
+int main(int argc, char *argv[]){
+    vector<double> scales={1, 10, 50};
+    unsigned long seed=1;
+    double duplicates=0.001, bad_rows=0.001;
+    int repeats=5;
+    string dir="/tmp", json_file;
+    bool keep=false;
+    for(int i=1; i<argc; i++){
+        string arg=argv[i];
+        size_t eq=arg.find('=');
+        string name=arg.substr(0, eq);
+        string value=eq==string::npos?"":arg.substr(eq+1);
+        try{
+            if(name=="--scales"){
+                scales.clear();
+                istringstream list(value);
+                string scale;
+                while(getline(list, scale, ','))
+                    scales.push_back(stod(scale));
+            }
+            else if(name=="--seed")
+                seed=stoul(value);
+            else if(name=="--duplicates")
+                duplicates=stod(value);
+            else if(name=="--bad-rows")
+                bad_rows=stod(value);
+            else if(name=="--repeats")
+                repeats=max(1, stoi(value));
+            else if(name=="--dir")
+                dir=value;
+            else if(arg=="--keep")
+                keep=true;
+            else if(name=="--json")
+                json_file=value;
+            else
+                throw invalid_argument(arg);
+        }catch(const exception &){
+            cerr<<"usage: "<<argv[0]<<" [--scales=1,10,50] [--seed=S] "
+                  "[--duplicates=R] [--bad-rows=R] [--repeats=N] [--dir=DIR] "
+                  "[--keep] [--json=FILE]\n";
+            return 1;
+        }
+    }
+
+    cout<<"scale       rows  file_MB  gen_s  load_s    trees  near_ms  "
+          "zip_ms  info_ms  id_us   rss_MB  peak_MB  B/tree\n";
+    vector<ScaleResult> results;
+    for(double scale:scales){
+        ScaleResult r={};
+        r.scale=scale;
+        r.rows=lround(scale*CensusGenerator::CENSUS_ROWS);
+        ostringstream name;
+        name<<dir<<"/nyc_trees_"<<scale<<"x.csv";
+        string path=name.str();
+
+        auto start=chrono::steady_clock::now();
+        {
+            ofstream out(path);
+            CensusGenerator generator(seed, duplicates, bad_rows);
+            generator.write_rows(out, r.rows);
+            out.close();
+            if(out.fail()){
+                cerr<<"Could not write "<<path<<"\n";
+                return 1;
+            }
+        }
+        r.generate_s=elapsed_ms(start)/1000;
+        struct stat file_stat;
+        if(stat(path.c_str(), &file_stat)==0)
+            r.file_mb=file_stat.st_size/double(1<<20);
+
+        r.loaded=run_scale(r, path, repeats);
+        if(!keep)
+            unlink(path.c_str());
+
+        cout<<setw(5)<<scale<<setw(11)<<r.rows<<fixed<<setprecision(1)
+            <<setw(9)<<r.file_mb<<setw(7)<<r.generate_s;
+        if(r.loaded)
+            cout<<setw(8)<<r.load_s<<setw(9)<<r.trees<<setprecision(2)
+                <<setw(9)<<r.near_ms<<setw(8)<<r.zip_ms<<setw(9)<<r.info_ms
+                <<setw(7)<<r.id_ms*1000<<setprecision(1)<<setw(9)<<r.rss_mb
+                <<setw(9)<<r.peak_mb<<setw(8)<<setprecision(0)
+                <<r.rss_mb*(1<<20)/max(r.trees, 1L)<<"\n";
+        else
+            cout<<"  did not finish loading (out of memory?)\n";
+        cout<<defaultfloat;
+        results.push_back(r);
+    }
+
+    if(!json_file.empty()){
+        ofstream out(json_file);
+        out<<"{\"benchmark\":\"nyc_trees_census_scaling\",\"seed\":"<<seed
+           <<",\"duplicate_rate\":"<<duplicates<<",\"bad_row_rate\":"
+           <<bad_rows<<",\"repeats\":"<<repeats<<",\"results\":[";
+        rep(i, (int)results.size()){
+            const ScaleResult &r=results[i];
+            out<<(i?",":"")<<"\n{\"scale\":"<<r.scale<<",\"rows\":"<<r.rows
+               <<",\"file_mb\":"<<r.file_mb<<",\"generate_s\":"<<r.generate_s
+               <<",\"loaded\":"<<(r.loaded?"true":"false");
+            if(r.loaded)
+                out<<",\"trees\":"<<r.trees<<",\"load_s\":"<<r.load_s
+                   <<",\"near_ms\":"<<r.near_ms<<",\"zip_ms\":"<<r.zip_ms
+                   <<",\"info_ms\":"<<r.info_ms<<",\"id_ms\":"<<r.id_ms
+                   <<",\"rss_mb\":"<<r.rss_mb<<",\"peak_mb\":"<<r.peak_mb;
+            out<<"}";
+        }
+        out<<"\n]}\n";
+        if(out.fail()){
+            cerr<<"Could not write "<<json_file<<"\n";
+            return 1;
+        }
+    }
+    return 0;
+}
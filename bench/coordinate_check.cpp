@@ -0,0 +1,77 @@
+/**
+    coordinate_check.cpp
+    @version 1.0 10/19/26
+    Purpose: To check that the coordinates of every row of a data file come
+             back exactly from the fixed-point units of the hot records, by
+             encoding and decoding each of them
+    Usage:   nyc_trees_coordinate_check <datafile>
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/Tree/tree.h"
+#include "../src/HotTrees/hot_trees.h"
+
+const long REPORTED_FAILURES=10;
+
+long failures=0;
+
+void fail(const string &what){
+    if(failures++<REPORTED_FAILURES)
+        cerr<<"FAILED: "<<what<<"\n";
+}
+
+/** round_trips(degrees,origin) is true if degrees encodes to units that
+ *  decode to exactly degrees again
+ */
+bool round_trips(double degrees, int64_t origin){
+    int32_t units;
+    bool exact=encode_coordinate(degrees, origin, units);
+    return exact && decode_coordinate(units, origin)==degrees;
+}
+
+int main(int argc, char *argv[]){
+    if(argc!=2){
+        cerr<<"usage: "<<argv[0]<<" datafile\n";
+        return 1;
+    }
+    ifstream in(argv[1]);
+    if(in.fail()){
+        cerr<<"Could not open data file "<<argv[1]<<" for reading\n";
+        return 1;
+    }
+
+    long line_number=0, checked=0, skipped=0;
+    string line;
+    while(getline(in, line)){
+        line_number++;
+        Tree t(line);
+        if(t.id()==0){
+            skipped++;
+            continue;
+        }
+        checked++;
+        double lat, lon;
+        t.get_position(lat, lon);
+        if(!round_trips(lat, LATITUDE_ORIGIN) ||
+           !round_trips(lon, LONGITUDE_ORIGIN)){
+            ostringstream what;
+            what<<setprecision(17)<<"line "<<line_number<<", tree "<<t.id()
+                <<": ("<<lat<<","<<lon<<") does not round-trip";
+            fail(what.str());
+        }
+    }
+
+    cout<<checked<<" rows checked, "<<skipped<<" lines skipped as not rows, "
+        <<failures<<" inexact\n";
+    return failures==0?0:1;
+}
@@ -0,0 +1,80 @@
+/**
+    generate_census.cpp
+    @version 1.0 10/19/26
+    Purpose: To write a synthetic data file of any size with
+             CensusGenerator, for testing the program beyond the size of the
+             real census
+    Usage:   nyc_trees_generate [--rows=N] [--scale=X] [--seed=S]
+                                [--duplicates=R] [--bad-rows=R]
+                                [--first-id=N] [OutputFile]
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/Generator/census_generator.h"
+
+int main(int argc, char *argv[]){
+    long rows=CensusGenerator::CENSUS_ROWS;
+    unsigned long seed=1;
+    double duplicates=0, bad_rows=0;
+    int first_id=1;
+    string output_file;
+    for(int i=1; i<argc; i++){
+        string arg=argv[i];
+        size_t eq=arg.find('=');
+        string name=arg.substr(0, eq);
+        string value=eq==string::npos?"":arg.substr(eq+1);
+        try{
+            if(name=="--rows")
+                rows=stol(value);
+            else if(name=="--scale")
+                rows=lround(stod(value)*CensusGenerator::CENSUS_ROWS);
+            else if(name=="--seed")
+                seed=stoul(value);
+            else if(name=="--duplicates")
+                duplicates=stod(value);
+            else if(name=="--bad-rows")
+                bad_rows=stod(value);
+            else if(name=="--first-id")
+                first_id=stoi(value);
+            else if(arg.compare(0, 2, "--")!=0 && output_file.empty())
+                output_file=arg;
+            else
+                throw invalid_argument(arg);
+        }catch(const exception &){
+            cerr<<"usage: "<<argv[0]<<" [--rows=N] [--scale=X] [--seed=S] "
+                  "[--duplicates=R] [--bad-rows=R] [--first-id=N] "
+                  "[OutputFile]\n";
+            return 1;
+        }
+    }
+
+    CensusGenerator generator(seed, duplicates, bad_rows, first_id);
+    if(output_file.empty())
+        generator.write_rows(cout, rows);
+    else{
+        ofstream out(output_file);
+        if(out.fail()){
+            cerr<<"Could not open "<<output_file<<" for writing\n";
+            return 1;
+        }
+        generator.write_rows(out, rows);
+        out.close();
+        if(out.fail()){
+            cerr<<"Could not write "<<output_file<<"\n";
+            return 1;
+        }
+    }
+    cerr<<generator.rows()<<" rows, "<<generator.duplicates()
+        <<" duplicates, "<<generator.bad_rows()<<" bad rows\n";
+    return 0;
+}
@@ -0,0 +1,379 @@
+/**
+    micro_bench.cpp
+    @version 1.0 10/19/26
+    Purpose: To time the building blocks of the commands one by one on
+             trees made by CensusGenerator: parsing a data file line, AVL
+             insert and find, the zip code and distance scans of the AVL
+             tree and of the hot records, in the order they were added and
+             in Hilbert order, haversine, species matching and the three
+             output formats. It also prints how many rows, cache lines and
+             pages of hot records a distance scan reads in each order.
+    Usage:   nyc_trees_bench [--trees=N] [--samples=N] [--sample-ms=M]
+                             [--filter=S] [--seed=S] [--counters]
+                             [--json=FILE]
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/TreeCollection/tree_collection.h"
+#include "../src/ResultWriter/result_writer.h"
+#include "../src/GPS/gps.h"
+#include "../src/Generator/census_generator.h"
+#include "../src/AVLTree/packed_key.h"
+#include "bench_harness.h"
+
+typedef AvlTree<Tree> TreeSet;
+typedef AvlTree<PackedTreeRef, PackedKeyOf> PackedSet;
+
+const char *PARTIAL_NAMES[]={"oak", "maple", "red", "london planetree",
+                             "elm", "apple", "no such tree"};
+const int INSERTS_PER_CALL=10000;
+const int LOOKUPS_PER_CALL=1000;
+const int ROWS_PER_CALL=1000;
+const double NEAR_DISTANCE=0.5;
+const int HEATMAP_CELLS[]={100, 400, 1600, 6400};
+
+/** class NullBuffer throws away everything written to it, so the output
+ *  benchmarks time the formatting and not the terminal or the disk
+ */
+class NullBuffer: public streambuf{
+    protected:
+    int overflow(int c) override{
+        return c;
+    }
+    streamsize xsputn(const char *, streamsize n) override{
+        return n;
+    }
+};
+
+/** make_rows(n,seed) returns n data file lines made by CensusGenerator */
+vector<string> make_rows(int n, unsigned seed){
+    CensusGenerator generator(seed);
+    vector<string> rows;
+    rows.reserve(n);
+    rep(i, n)
+        rows.push_back(generator.next_row());
+    return rows;
+}
+
+/** packed_refs(trees) files each tree under pack_tree_key(species,id), with
+ *  the species numbered in the order of their lower case names, which is
+ *  the order of operator<
+ */
+vector<PackedTreeRef> packed_refs(const vector<Tree> &trees){
+    auto lower_name=[](const Tree &t){
+        string name=t.common_name();
+        transform(name.begin(), name.end(), name.begin(),
+                  [](unsigned char c){ return tolower(c); });
+        return name;
+    };
+    map<string, uint32_t> species;
+    for(const auto &t:trees)
+        species[lower_name(t)]=0;
+    uint32_t number=0;
+    for(auto &entry:species)
+        entry.second=number++;
+    vector<PackedTreeRef> refs;
+    refs.reserve(trees.size());
+    for(const auto &t:trees)
+        refs.push_back({pack_tree_key(species[lower_name(t)], t.id()), &t});
+    return refs;
+}
+
+/** print_near_footprint(trees,samples,seed) prints how many rows, 64-byte
+ *  lines and 4 KiB pages of hot records find_near() reads on average, with
+ *  the rows in the order the trees were added and in Hilbert order
+ */
+void print_near_footprint(const vector<Tree> &trees, int samples,
+                          unsigned seed){
+    HotTrees added, ordered;
+    for(const auto &t:trees){
+        added.add(t);
+        ordered.add(t);
+    }
+    ordered.order_by_position();
+    cout<<"\nhot records read by find_near("<<NEAR_DISTANCE<<" km), per query"
+        <<"\n"<<left<<setw(28)<<"order"<<right<<setw(14)<<"rows"
+        <<setw(14)<<"lines"<<setw(14)<<"pages"<<"\n";
+    for(const HotTrees *hot:{&added, &ordered}){
+        mt19937 random(seed);
+        double rows=0, lines=0, pages=0;
+        rep(i, samples){
+            double latitude, longitude, lat_span, lon_span;
+            trees[random()%trees.size()].get_position(latitude, longitude);
+            distance_bounds(GPS(latitude, longitude), NEAR_DISTANCE,
+                            lat_span, lon_span);
+            PositionBox box=position_box(latitude, longitude, lat_span,
+                                         lon_span);
+            for(const auto &span:hot->box_spans(box)){
+                size_t first=span.first*sizeof(HotTree);
+                size_t last=span.second*sizeof(HotTree)-1;
+                rows+=span.second-span.first;
+                lines+=last/64-first/64+1;
+                pages+=last/4096-first/4096+1;
+            }
+        }
+        cout<<left<<setw(28)<<(hot==&added?"added":"hilbert")<<right
+            <<fixed<<setprecision(1)<<setw(14)<<rows/samples<<setw(14)
+            <<lines/samples<<setw(14)<<pages/samples<<"\n"<<defaultfloat;
+    }
+}
+
+Command make_command(const string &line){
+    istringstream in(line+"\n");
+    Command command;
+    command.get_next(in);
+    return command;
+}
+
+int main(int argc, char *argv[]){
+    int num_trees=100000, samples=10;
+    double sample_ms=50;
+    unsigned seed=1;
+    string filter, json_file;
+    bool counters=false;
+    for(int i=1; i<argc; i++){
+        string arg=argv[i];
+        size_t eq=arg.find('=');
+        string name=arg.substr(0, eq);
+        string value=eq==string::npos?"":arg.substr(eq+1);
+        try{
+            if(name=="--trees")
+                num_trees=stoi(value);
+            else if(name=="--samples")
+                samples=stoi(value);
+            else if(name=="--sample-ms")
+                sample_ms=stod(value);
+            else if(name=="--filter")
+                filter=value;
+            else if(name=="--seed")
+                seed=stoul(value);
+            else if(name=="--json")
+                json_file=value;
+            else if(arg=="--counters")
+                counters=true;
+            else
+                throw invalid_argument(arg);
+        }catch(const exception &){
+            cerr<<"usage: "<<argv[0]<<" [--trees=N] [--samples=N] "
+                  "[--sample-ms=M] [--filter=S] [--seed=S] [--counters] "
+                  "[--json=FILE]\n";
+            return 1;
+        }
+    }
+    if(num_trees<INSERTS_PER_CALL){
+        cerr<<"--trees must be at least "<<INSERTS_PER_CALL<<"\n";
+        return 1;
+    }
+
+    vector<string> rows=make_rows(num_trees, seed);
+    vector<Tree> trees(rows.begin(), rows.end());
+    TreeSet tree_set(Tree(0, "ITEM_NOT_FOUND"));
+    TreeSpecies species;
+    for(const auto &t:trees){
+        tree_set.insert(t);
+        species.add_species(t.common_name());
+    }
+    if(tree_set.size()!=num_trees){
+        cerr<<"only "<<tree_set.size()<<" of "<<num_trees
+            <<" rows are distinct valid trees\n";
+        return 1;
+    }
+
+    //the same trees under packed keys, their species numbered in name order
+    vector<PackedTreeRef> refs=packed_refs(trees);
+    PackedSet packed_set(PackedTreeRef{0, nullptr});
+    for(const auto &ref:refs)
+        packed_set.insert(ref);
+    bool same_order=true;
+    int position=0;
+    packed_set.forEach([&](const PackedTreeRef &ref){
+        same_order=same_order && *ref.tree==tree_set.select(position++);
+    });
+    if(!same_order || position!=tree_set.size()){
+        cerr<<"the packed keys do not sort as the trees do\n";
+        return 1;
+    }
+
+    //the hot records must give back the coordinates of every tree exactly,
+    //as nyc_trees_coordinate_check checks for a data file; by_position
+    //holds them in Hilbert order
+    TreeCollection collection;
+    for(const auto &t:trees){
+        Tree copy=t;
+        collection.add_tree(move(copy));
+        double lat, lon;
+        int32_t units;
+        t.get_position(lat, lon);
+        if(!encode_coordinate(lat, LATITUDE_ORIGIN, units) ||
+           !encode_coordinate(lon, LONGITUDE_ORIGIN, units)){
+            cerr<<"the coordinates of tree "<<t.id()
+                <<" do not round-trip through the hot records\n";
+            return 1;
+        }
+    }
+    TreeCollection by_position(collection);
+    by_position.order_by_position();
+
+    mt19937 random(seed);
+    BenchHarness bench(samples, sample_ms, filter, counters);
+    size_t next=0;
+
+    bench.run("parse_tree_row", LOOKUPS_PER_CALL, [&]{
+        rep(i, LOOKUPS_PER_CALL){
+            Tree t(rows[next]);
+            keep(t);
+            next=(next+1)%rows.size();
+        }
+    });
+
+    bench.run("avl_insert", INSERTS_PER_CALL, [&]{
+        TreeSet s(Tree(0, "ITEM_NOT_FOUND"));
+        rep(i, INSERTS_PER_CALL)
+            keep(s.insert(trees[i]));
+    });
+
+    bench.run("avl_find", LOOKUPS_PER_CALL, [&]{
+        rep(i, LOOKUPS_PER_CALL){
+            keep(tree_set.find(trees[next]));
+            next=(next+1)%trees.size();
+        }
+    });
+
+    bench.run("avl_insert_packed", INSERTS_PER_CALL, [&]{
+        PackedSet s(PackedTreeRef{0, nullptr});
+        rep(i, INSERTS_PER_CALL)
+            keep(s.insert(refs[i]));
+    });
+
+    bench.run("avl_find_packed", LOOKUPS_PER_CALL, [&]{
+        rep(i, LOOKUPS_PER_CALL){
+            keep(packed_set.find(refs[next]));
+            next=(next+1)%refs.size();
+        }
+    });
+
+    bench.run("avl_scan_zip", 1, [&]{
+        Tree key(trees[random()%trees.size()].zip_code());
+        keep(tree_set.findIf([&key](const Tree &t){
+            return issamezip(key, t);
+        }));
+    });
+
+    bench.run("avl_scan_near", 1, [&]{
+        double latitude, longitude;
+        trees[random()%trees.size()].get_position(latitude, longitude);
+        Tree center(0, "", latitude, longitude);
+        keep(tree_set.findIf([&center](const Tree &t){
+            return isclose(center, t, NEAR_DISTANCE);
+        }));
+    });
+
+    bench.run("hot_find_in_zipcode", 1, [&]{
+        keep(collection.find_in_zipcode(
+            trees[random()%trees.size()].zip_code()));
+    });
+
+    bench.run("hot_find_near", 1, [&]{
+        double latitude, longitude;
+        trees[random()%trees.size()].get_position(latitude, longitude);
+        keep(collection.find_near(latitude, longitude, NEAR_DISTANCE));
+    });
+
+    bench.run("hilbert_find_near", 1, [&]{
+        double latitude, longitude;
+        trees[random()%trees.size()].get_position(latitude, longitude);
+        keep(by_position.find_near(latitude, longitude, NEAR_DISTANCE));
+    });
+
+    //a heatmap counted from the trees, then added up from the pyramid
+    bench.run("heatmap_scan", 1, [&]{
+        HeatLayer layer(HEATMAP_CELLS[random()%size(HEATMAP_CELLS)]);
+        for(const Tree &t:trees){
+            double latitude, longitude;
+            t.get_position(latitude, longitude);
+            layer.add(latitude, longitude);
+        }
+        keep(layer.cells());
+    });
+
+    bench.run("heatmap_pyramid", 1, [&]{
+        keep(collection.heatmap(HEATMAP_CELLS[random()%size(HEATMAP_CELLS)]));
+    });
+
+    bench.run("diversity_grid", 1, [&]{
+        keep(collection.diversity(
+            HEATMAP_CELLS[random()%size(HEATMAP_CELLS)]));
+    });
+
+    //the species of a random tree, so that common species come up as often
+    //as they do in the data
+    bench.run("nearest_same_species", 1, [&]{
+        keep(collection.nearest_same_species(
+            trees[random()%trees.size()].common_name()));
+    });
+
+    bench.run("haversine", LOOKUPS_PER_CALL, [&]{
+        double latitude, longitude, total=0;
+        trees[next].get_position(latitude, longitude);
+        next=(next+1)%trees.size();
+        rep(i, LOOKUPS_PER_CALL){
+            double other_latitude, other_longitude;
+            trees[i].get_position(other_latitude, other_longitude);
+            total+=haversine(latitude, longitude, other_latitude,
+                             other_longitude);
+        }
+        keep(total);
+    });
+
+    bench.run("get_matching_species", 1, [&]{
+        keep(species.get_matching_species(
+            PARTIAL_NAMES[random()%size(PARTIAL_NAMES)]));
+    });
+
+    bench.run("find_matching_species", 1, [&]{
+        keep(species.find_matching_species(
+            PARTIAL_NAMES[random()%size(PARTIAL_NAMES)]));
+    });
+
+    //the rows of a print_all, written in each format
+    NullBuffer null_buffer;
+    ostream null_stream(&null_buffer);
+    Command print_all=make_command("print_all");
+    const char *format_names[]={"text", "jsonl", "csv"};
+    rep(f, num_Output_formats){
+        unique_ptr<__ResultWriter> writer=
+            make_result_writer((Output_format)f, null_stream);
+        bench.run(string("write_tree_")+format_names[f], ROWS_PER_CALL, [&]{
+            writer->begin_command(print_all);
+            rep(i, ROWS_PER_CALL)
+                writer->tree(trees[i]);
+            writer->end_command();
+            writer->flush();
+        });
+    }
+
+    if(string("near_footprint").find(filter)!=string::npos)
+        print_near_footprint(trees, 200, seed);
+
+    if(!json_file.empty()){
+        ofstream out(json_file);
+        bench.write_json(out, "\"benchmark\":\"nyc_trees_bench\",\"trees\":"+
+                              to_string(num_trees)+",\"seed\":"+
+                              to_string(seed));
+        if(out.fail()){
+            cerr<<"Could not write "<<json_file<<"\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+    scaling_bench.cpp
+    @version 1.0 10/19/26
+    Purpose: To time loading and the full tree scans of list_near and
+             listall_inzip with 1 to N scheduler threads
+    Usage:   nyc_trees_scaling_bench <datafile> [max_threads] [repeats]
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/TreeCollection/tree_collection.h"
+#include "../src/Loader/tree_loader.h"
+#include "../src/Scheduler/task_scheduler.h"
+
+// points and zip codes spread over the five boroughs
+const double NEAR_POINTS[][2]={{40.7831, -73.9712}, {40.6782, -73.9442},
+                               {40.7282, -73.7949}, {40.8448, -73.8648},
+                               {40.5795, -74.1502}};
+const int ZIPCODES[]={10025, 11215, 11375, 10467, 10314};
+const double NEAR_DISTANCE=1.0;
+
+double elapsed_ms(chrono::steady_clock::time_point start){
+    return chrono::duration<double, milli>(chrono::steady_clock::now()-start)
+           .count();
+}
+
+int main(int argc, char *argv[]){
+    if(argc<2 || argc>4){
+        cerr<<"usage: "<<argv[0]<<" datafile [max_threads] [repeats]\n";
+        return 1;
+    }
+    size_t max_threads=argc>2?stoul(argv[2]):
+                       max(1u, thread::hardware_concurrency());
+    int repeats=argc>3?stoi(argv[3]):5;
+
+    cout<<"threads     load_ms     near_ms      zip_ms  near_speedup"
+          "  zip_speedup\n";
+    double near_base=0, zip_base=0;
+    for(size_t threads=1; threads<=max_threads; threads++){
+        TaskScheduler scheduler(threads);
+        SchedulerScope scope(scheduler);
+
+        ifstream in(argv[1]);
+        if(in.fail()){
+            cerr<<"Could not open data file "<<argv[1]<<" for reading\n";
+            return 1;
+        }
+        TreeCollection trees;
+        auto start=chrono::steady_clock::now();
+        TreeLoader(trees).load(in);
+        double load_ms=elapsed_ms(start);
+
+        //the sizes keep the scans from being optimized away
+        size_t found=0;
+        start=chrono::steady_clock::now();
+        rep(r, repeats)
+            for(auto &p:NEAR_POINTS)
+                found+=trees.get_all_near(p[0], p[1], NEAR_DISTANCE).size();
+        double near_ms=elapsed_ms(start)/repeats;
+
+        start=chrono::steady_clock::now();
+        rep(r, repeats)
+            for(int zip:ZIPCODES)
+                found+=trees.get_all_in_zipcode(zip).size();
+        double zip_ms=elapsed_ms(start)/repeats;
+
+        if(threads==1){
+            near_base=near_ms;
+            zip_base=zip_ms;
+        }
+        cout<<fixed<<setprecision(2)<<setw(7)<<threads<<setw(12)<<load_ms
+            <<setw(12)<<near_ms<<setw(12)<<zip_ms<<setw(14)
+            <<near_base/near_ms<<setw(13)<<zip_base/zip_ms<<"\n";
+        if(found==0)
+            cerr<<"no trees found by the scans\n";
+    }
+    return 0;
+}
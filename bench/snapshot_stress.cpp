@@ -0,0 +1,159 @@
+/**
+    snapshot_stress.cpp
+    @version 1.0 10/19/26
+    Purpose: To check that AvlTree snapshots stay consistent while a writer
+             keeps inserting, by running list_near and tree_info style
+             queries on them from several reader threads
+    Usage:   nyc_trees_snapshot_stress <datafile> [readers] [publish_every]
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "../src/Tree/tree.h"
+#include "../src/AVLTree/AvlTree.h"
+#include "../src/Snapshot/snapshot_slot.h"
+
+typedef AvlTree<Tree> TreeSet;
+
+const double NEAR_DISTANCE=0.5;
+
+atomic<long> failures(0);
+
+void fail(const string &what){
+    if(failures++<10)
+        cerr<<"FAILED: "<<what<<"\n";
+}
+
+/** check_snapshot(s,last_size,random) runs one round of reader checks on s.
+ *  The sizes a reader sees must never shrink, an in-order walk must see
+ *  size() items in increasing order, list_near must return the trees a full
+ *  scan finds, and the species count of a tree must match the walk.
+ */
+void check_snapshot(const TreeSet &s, int &last_size, mt19937 &random){
+    int n=s.size();
+    if(n<last_size)
+        fail("snapshot size went from "+to_string(last_size)+" to "+
+             to_string(n));
+    last_size=n;
+    if(n==0)
+        return;
+
+    //tree_info: find a tree by key and count its species
+    const Tree &picked=s.select(uniform_int_distribution<int>(0, n-1)(random));
+    if(!(s.find(picked)==picked))
+        fail("find() lost tree "+to_string(picked.id()));
+    string name=picked.common_name();
+    int species_count=s.countRange(Tree(0, name),
+                                   Tree(0, name, 0, 0, INT_MAX));
+
+    //list_near around the picked tree
+    double latitude, longitude;
+    picked.get_position(latitude, longitude);
+    Tree center(0, "", latitude, longitude);
+    size_t near=s.findIf([&center](const Tree &t){
+        return isclose(center, t, NEAR_DISTANCE);
+    }).size();
+
+    int walked=0, same_species=0;
+    size_t scanned_near=0;
+    const Tree *previous=nullptr;
+    s.forEach([&](const Tree &t){
+        if(previous!=nullptr && !(*previous<t))
+            fail("walk out of order at tree "+to_string(t.id()));
+        previous=&t;
+        walked++;
+        if(t.common_name()==name)
+            same_species++;
+        if(isclose(center, t, NEAR_DISTANCE))
+            scanned_near++;
+    });
+    if(walked!=n)
+        fail("walk saw "+to_string(walked)+" of "+to_string(n)+" trees");
+    if(same_species!=species_count)
+        fail("species count of "+name+" is "+to_string(species_count)+
+             ", walk found "+to_string(same_species));
+    if(near!=scanned_near)
+        fail("list_near found "+to_string(near)+" trees, scan found "+
+             to_string(scanned_near));
+}
+
+int main(int argc, char *argv[]){
+    if(argc<2 || argc>4){
+        cerr<<"usage: "<<argv[0]<<" datafile [readers] [publish_every]\n";
+        return 1;
+    }
+    int readers=argc>2?stoi(argv[2]):4;
+    int publish_every=argc>3?stoi(argv[3]):64;
+
+    ifstream in(argv[1]);
+    if(in.fail()){
+        cerr<<"Could not open data file "<<argv[1]<<" for reading\n";
+        return 1;
+    }
+    vector<Tree> rows;
+    string line;
+    while(getline(in, line)){
+        Tree t(line);
+        if(t.id()!=0)
+            rows.push_back(t);
+    }
+
+    TreeSet tree(Tree(0, "ITEM_NOT_FOUND"));
+    SnapshotSlot<TreeSet> slot;
+    slot.publish(tree.snapshot());
+    atomic<bool> writing(true);
+    atomic<long> rounds(0);
+
+    vector<thread> threads;
+    for(int r=0; r<readers; r++)
+        threads.emplace_back([&, r]{
+            mt19937 random(r+1);
+            int last_size=0;
+            while(writing){
+                check_snapshot(*slot.acquire(), last_size, random);
+                rounds++;
+            }
+            check_snapshot(*slot.acquire(), last_size, random);
+        });
+
+    auto start=chrono::steady_clock::now();
+    long published=0;
+    for(size_t i=0; i<rows.size(); i++){
+        tree.insert(rows[i]);
+        if((i+1)%publish_every==0){
+            slot.publish(tree.snapshot());
+            published++;
+        }
+    }
+    slot.publish(tree.snapshot());
+    double write_ms=chrono::duration<double, milli>(
+                        chrono::steady_clock::now()-start).count();
+    writing=false;
+    for(auto &t:threads)
+        t.join();
+
+    //the writer's tree must hold what a plain serial build holds
+    TreeSet serial(Tree(0, "ITEM_NOT_FOUND"));
+    for(const auto &t:rows)
+        serial.insert(t);
+    vector<int> expected, got;
+    serial.forEach([&](const Tree &t){ expected.push_back(t.id()); });
+    tree.forEach([&](const Tree &t){ got.push_back(t.id()); });
+    if(expected!=got)
+        fail("final tree differs from a serial build");
+
+    cout<<rows.size()<<" inserts in "<<fixed<<setprecision(1)<<write_ms
+        <<" ms with "<<readers<<" readers, "<<published
+        <<" snapshots published, "<<rounds<<" reader rounds, "<<failures
+        <<" failures\n";
+    return failures==0?0:1;
+}
@@ -20,53 +20,139 @@ License         : Copyright 2020 Keisuke Suzuki, based on code written by
     GNU General Public License for more details.
 *******************************************************************************/
 #include "../Tree/tree.h"
+#include "../Scheduler/task_scheduler.h"
 #include "AvlTree.h"
+#include "packed_key.h"
 
 using namespace std;
 
 /**************************Public Member Functions*****************************/
 
-// explicit instantiation of Tree class for separating files
+#define AVL_TEMPLATE \
+    template <class Comparable, class KeyOf, class Compare, class Alloc>
+#define AVL_TREE AvlTree<Comparable, KeyOf, Compare, Alloc>
+
+// explicit instantiation of Tree class for separating files, and of the
+// packed key trees
 template class AvlTree<Tree>;
+template class AvlTree<PackedTreeRef, PackedKeyOf>;
+template class AvlTree<PackedCount, PackedKeyOf>;
+
+/** forkDepth(n) returns how many levels the scans of findIf() split into
+ *  tasks
+ */
+int forkDepth(int n){
+    size_t workers=TaskScheduler::current().size();
+    if(workers<=1 || n<MIN_PARALLEL_SUBTREE)
+        return 0;
+    int depth=2;
+    while(workers>1){
+        workers/=2;
+        depth++;
+    }
+    return depth;
+}
 
 /** AvlTree is a default constructor
   */
-template <class Comparable>
-    AvlTree<Comparable>::AvlTree(const Comparable &notFound):
+AVL_TEMPLATE
+    AVL_TREE::AvlTree(const Comparable &notFound):
                                     ITEM_NOT_FOUND(notFound), root(nullptr){
     }
 
 /**
  * Copy constructor.
  */
-template <class Comparable>
-    AvlTree<Comparable>::AvlTree(const AvlTree<Comparable> &rhs):
+AVL_TEMPLATE
+    AVL_TREE::AvlTree(const AVL_TREE &rhs):
                           ITEM_NOT_FOUND(rhs.ITEM_NOT_FOUND), root(nullptr){
         *this=rhs;
     }
 
+/**
+ * Constructor of snapshot(); shares the nodes of rhs.
+ */
+AVL_TEMPLATE
+    AVL_TREE::AvlTree(const AVL_TREE &rhs, Share):
+                          root(rhs.root), ITEM_NOT_FOUND(rhs.ITEM_NOT_FOUND){
+        if(root!=nullptr)
+            root->refs.fetch_add(1, memory_order_relaxed);
+    }
+
 /**
  * Destructor for the tree.
  */
-template <class Comparable>
-    AvlTree<Comparable>::~AvlTree(){
+AVL_TEMPLATE
+    AVL_TREE::~AvlTree(){
         makeEmpty();
     }
 
 /**
  * Insert x into the tree; duplicates are ignored.
+ * Return the address of the stored item, or of the item x duplicates.
+ * The address stays valid until that item is removed from the tree.
+ */
+AVL_TEMPLATE
+    const Comparable *AVL_TREE::insert(const Comparable &x){
+        const Comparable *stored=nullptr;
+        insert(x, root, stored);
+        return stored;
+    }
+
+/**
+ * Insert x into the tree, moving it into the new node.
+ */
+AVL_TEMPLATE
+    const Comparable *AVL_TREE::insert(Comparable &&x){
+        const Comparable *stored=nullptr;
+        insert(move(x), root, stored);
+        return stored;
+    }
+
+/**
+ * Remove x from the tree. Nothing is done if x is not found.
+ * Return true if x was removed.
+ */
+AVL_TEMPLATE
+    bool AVL_TREE::remove(const Comparable &x){
+        bool removed=false;
+        if(find(x, root)!=nullptr)
+            remove(x, root, removed);
+        return removed;
+    }
+
+/**
+ * Return a read-only copy of the tree that shares all of its nodes.
+ */
+AVL_TEMPLATE
+    shared_ptr<const AVL_TREE> AVL_TREE::snapshot()
+                                                                        const{
+        return shared_ptr<const AvlTree>(new AvlTree(*this, Share()));
+    }
+
+/**
+ * Return a copy of the tree that shares all of its nodes.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::insert(const Comparable &x){
-        insert(x, root);
+AVL_TEMPLATE
+    AVL_TREE AVL_TREE::share() const{
+        return AvlTree(*this, Share());
+    }
+
+/**
+ * Set the function insert() calls when it moves an item to a new node.
+ */
+AVL_TEMPLATE
+    void AVL_TREE::onRelocate(function<void(const Comparable *,
+                                                       const Comparable *)> f){
+        relocated=move(f);
     }
 
 /**
  * Find the smallest item in the tree.
  * Return smallest item or ITEM_NOT_FOUND if empty.
  */
-template <class Comparable>
-    const Comparable &AvlTree<Comparable>::findMin() const{
+AVL_TEMPLATE
+    const Comparable &AVL_TREE::findMin() const{
         return elementAt(findMin(root));
     }
 
@@ -74,8 +160,8 @@ template <class Comparable>
  * Find the largest item in the tree.
  * Return the largest item of ITEM_NOT_FOUND if empty.
  */
-template <class Comparable>
-    const Comparable &AvlTree<Comparable>::findMax() const{
+AVL_TEMPLATE
+    const Comparable &AVL_TREE::findMax() const{
         return elementAt(findMax(root));
     }
 
@@ -83,34 +169,85 @@ template <class Comparable>
  * Find item x in the tree.
  * Return the matching item or ITEM_NOT_FOUND if not found.
  */
-template <class Comparable>
-    const Comparable &AvlTree<Comparable>::find(const Comparable &x) const{
+AVL_TEMPLATE
+    const Comparable &AVL_TREE::find(const Comparable &x) const{
         return elementAt(find(x, root));
     }
 
-/** getSameZip() finds the identical items in the tree by comparing function,
- *  and returns the matching items
+/**
+ * Return the number of items in the tree.
  */
-template <class Comparable>
-    list<Comparable> AvlTree<Comparable>::getSameZip(const Comparable
-                                                             &x) const{
-    return getSameZip(x, root);
+AVL_TEMPLATE
+    int AVL_TREE::size() const{
+        return size(root);
     }
 
-/** getSameZip() finds the identical items in the tree by comparing function,
-*  and returns the matching items
-*/
-template <class Comparable>
-    list<Comparable> AvlTree<Comparable>::
-                    getCloseElem(const Comparable &x, double distance) const{
-        return getCloseElem(x, root, distance);
+/**
+ * Return the bytes of heap the nodes take: one allocation per item.
+ */
+AVL_TEMPLATE
+    size_t AVL_TREE::nodeBytes() const{
+        return size()*heap_block(sizeof(AvlNode<Comparable>));
+    }
+
+/**
+ * Return the number of items less than x.
+ * Walks one root-to-leaf path, adding up the left subtree sizes.
+ */
+AVL_TEMPLATE
+    int AVL_TREE::rank(const Comparable &x) const{
+        int result=0;
+        AvlNode<Comparable> *t=root;
+        while(t!=nullptr)
+            if(less(t->element, x)){
+                result+=size(t->left)+1;
+                t=t->right;
+            }
+            else
+                t=t->left;
+        return result;
+    }
+
+/**
+ * Return the item at position k in sorted order, counting from 0.
+ * Return ITEM_NOT_FOUND if k is out of range.
+ */
+AVL_TEMPLATE
+    const Comparable &AVL_TREE::select(int k) const{
+        AvlNode<Comparable> *t=root;
+        while(t!=nullptr){
+            int left_size=size(t->left);
+            if(k<left_size)
+                t=t->left;
+            else if(k==left_size)
+                break;
+            else{
+                k-=left_size+1;
+                t=t->right;
+            }
+        }
+        return elementAt(t);
+    }
+
+/**
+ * Return the number of items x with lo <= x <= hi.
+ */
+AVL_TEMPLATE
+    int AVL_TREE::countRange(const Comparable &lo,
+                                        const Comparable &hi) const{
+        if(less(hi, lo))
+            return 0;
+        int result=rank(hi)-rank(lo);
+        if(find(hi, root)!=nullptr)
+            result++;
+        return result;
     }
 
 /**
  * Make the tree logically empty.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::makeEmpty(){
+AVL_TEMPLATE
+    void AVL_TREE::makeEmpty(){
         makeEmpty(root);
     }
 
@@ -118,28 +255,28 @@ template <class Comparable>
  * Test if the tree is logically empty.
  * Return true if empty, false otherwise.
  */
-template <class Comparable>
-    bool AvlTree<Comparable>::isEmpty() const{
+AVL_TEMPLATE
+    bool AVL_TREE::isEmpty() const{
         return root==nullptr;
     }
 
 /**
- * Print the tree contents in sorted order.
+ * Print the tree contents in sorted order on out.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::printTree() const{
+AVL_TEMPLATE
+    void AVL_TREE::printTree(ostream &out) const{
         if(isEmpty())
-            cout<<"Empty tree"<<endl;
+            out<<"Empty tree"<<'\n';
         else
-            printTree(root);
+            printTree(out, root);
     }
 
 /**
  * Deep copy.
  */
-template <class Comparable>
-    const AvlTree<Comparable> &AvlTree<Comparable>::operator=
-                                           (const AvlTree<Comparable> &rhs){
+AVL_TEMPLATE
+    const AVL_TREE &AVL_TREE::operator=
+                                           (const AVL_TREE &rhs){
         if(this!=&rhs){
             makeEmpty();
             root=clone(rhs.root);
@@ -153,44 +290,106 @@ template <class Comparable>
  * Internal method to get element field in node t.
  * Return the element field or ITEM_NOT_FOUND if t is NULL.
  */
-template <class Comparable>
+AVL_TEMPLATE
     const Comparable &
-    AvlTree<Comparable>::elementAt(AvlNode<Comparable> *t) const{
+    AVL_TREE::elementAt(AvlNode<Comparable> *t) const{
         return t==nullptr?ITEM_NOT_FOUND:t->element;
     }
 
 /**
  * Internal method to insert into a subtree.
- * x is the item to insert.
+ * x is the item to insert; an rvalue is moved into the new node.
  * t is the node that roots the tree.
+ * stored is set to the element that holds x after the insertion.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::insert(const Comparable &x,
-                                     AvlNode<Comparable> *&t) const{
-        if(t==nullptr)
-            t=new AvlNode<Comparable>(x, nullptr, nullptr);
-        else if(x<t->element){
-            insert(x, t->left);
+AVL_TEMPLATE
+template <class Item>
+    void AVL_TREE::insert(Item &&x, AvlNode<Comparable> *&t,
+                                     const Comparable *&stored) const{
+        if(t==nullptr){
+            t=newNode(std::forward<Item>(x), nullptr, nullptr);
+            stored=&t->element;
+            return;
+        }
+        unshare(t);
+        //x may have been moved into its node below, so the rotations compare
+        //the stored item, which equals it
+        if(less(x, t->element)){
+            insert(std::forward<Item>(x), t->left, stored);
             if(height(t->left)-height(t->right)==2)
-                if(x<t->left->element) rotateWithLeftChild(t);
+                if(less(*stored, t->left->element)) rotateWithLeftChild(t);
                 else doubleWithLeftChild(t);
         }
-        else if(t->element<x){
-            insert(x, t->right);
+        else if(less(t->element, x)){
+            insert(std::forward<Item>(x), t->right, stored);
             if(height(t->right)-height(t->left)==2)
-                if(t->right->element<x) rotateWithRightChild(t);
+                if(less(t->right->element, *stored)) rotateWithRightChild(t);
                 else doubleWithRightChild(t);
         }
-        else;  // Duplicate; do nothing
-        t->height=max(height(t->left), height(t->right))+1;
+        else stored=&t->element;  // Duplicate; do nothing
+        update(t);
+    }
+
+/**
+ * Internal method to remove from a subtree.
+ * x is the item to remove.
+ * t is the node that roots the tree.
+ * removed is set to true if x was found.
+ * A node with two children takes the item of the smallest node on its right.
+ */
+AVL_TEMPLATE
+    void AVL_TREE::remove(const Comparable &x,
+                                     AvlNode<Comparable> *&t,
+                                     bool &removed) const{
+        if(t==nullptr)
+            return;
+        unshare(t);
+        if(less(x, t->element))
+            remove(x, t->left, removed);
+        else if(less(t->element, x))
+            remove(x, t->right, removed);
+        else{
+            removed=true;
+            AvlNode<Comparable> *old=t;
+            if(t->left!=nullptr && t->right!=nullptr){
+                old=detachMin(t->right);
+                t->element=old->element;
+                if(relocated)
+                    relocated(&old->element, &t->element);
+            }
+            else
+                t=t->left!=nullptr?t->left:t->right;
+            //the children of old now hang elsewhere
+            old->left=old->right=nullptr;
+            makeEmpty(old);
+        }
+        balance(t);
+    }
+
+/**
+ * Internal method to unlink the smallest node of subtree t.
+ * Return that node; its right child takes its place.
+ */
+AVL_TEMPLATE
+    AvlNode<Comparable> *AVL_TREE::detachMin(AvlNode<Comparable>
+                                                        *&t) const{
+        unshare(t);
+        if(t->left==nullptr){
+            AvlNode<Comparable> *min=t;
+            t=t->right;
+            return min;
+        }
+        AvlNode<Comparable> *min=detachMin(t->left);
+        balance(t);
+        return min;
     }
 
 /**
  * Internal method to find the smallest item in a subtree t.
  * Return node containing the smallest item.
  */
-template <class Comparable>
-    AvlNode<Comparable> *AvlTree<Comparable>::findMin(AvlNode<Comparable> *t)
+AVL_TEMPLATE
+    AvlNode<Comparable> *AVL_TREE::findMin(AvlNode<Comparable> *t)
                                                                         const{
         if(t==nullptr)
             return t;
@@ -205,9 +404,9 @@ template <class Comparable>
  * Internal method to find the largest item in a subtree t.
  * Return node containing the largest item.
  */
-template <class Comparable>
+AVL_TEMPLATE
     AvlNode<Comparable> *
-    AvlTree<Comparable>::findMax(AvlNode<Comparable> *t) const{
+    AVL_TREE::findMax(AvlNode<Comparable> *t) const{
         if(t==nullptr)
             return t;
         
@@ -223,13 +422,13 @@ template <class Comparable>
  * t is the node that roots the tree.
  * Return node containing the matched item.
  */
-template <class Comparable>
-    AvlNode<Comparable> * AvlTree<Comparable>::find(const Comparable &x,
+AVL_TEMPLATE
+    AvlNode<Comparable> * AVL_TREE::find(const Comparable &x,
                                                 AvlNode<Comparable> *t) const{
         while(t!=nullptr)
-            if(x<t->element)
+            if(less(x, t->element))
                 t=t->left;
-            else if(t->element<x)
+            else if(less(t->element, x))
                 t=t->right;
             else
                 return t;    // Match
@@ -237,68 +436,52 @@ template <class Comparable>
         return nullptr;   // No match
     }
 
-/** internal method for getSameZip()
- *  @return list<Comparable> : list of items that have identical zipcode
- */
-template <class Comparable>
-    list<Comparable> AvlTree<Comparable>::getSameZip(const Comparable &x,
-                                              AvlNode<Comparable> *t) const{
-        if(t==nullptr) return list<Comparable>();
-        
-        list<Tree> left_list, right_list;
-        left_list=getSameZip(x, t->left);
-        //add element to left_list if match
-        if(issamezip(x,t->element))  left_list.push_back(t->element);
-        right_list=getSameZip(x, t->right);
-        //combine lists
-        left_list.splice(left_list.end(),right_list);
-        return left_list;
-    }
-
-/** internal method for getCloseElem()
-*  @return list<Comparable> : list of items that are close enough to x
-*/
-template <class Comparable>
-    list<Comparable> AvlTree<Comparable>::getCloseElem(const Comparable
-    &x,
-                            AvlNode<Comparable> *t, double distance) const{
-        if(t==nullptr)
-            return list<Comparable>();
-        
-        list<Tree> left_list, right_list;
-        left_list=getCloseElem(x,t->left, distance);
-        //add element to left_list if close
-        if(isclose(x,t->element,distance))  left_list.push_back(t->element);
-        right_list=getCloseElem(x, t->right,distance);
-        //combine lists
-        left_list.splice(left_list.end(),right_list);
-        return left_list;
-    }
-
 /**
  * Internal method to make subtree empty.
+ * Nodes that a snapshot still shares are left to the snapshot.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::makeEmpty(AvlNode<Comparable> *&t) const{
-        if(t!=nullptr){
+AVL_TEMPLATE
+    void AVL_TREE::makeEmpty(AvlNode<Comparable> *&t) const{
+        if(t!=nullptr && t->refs.fetch_sub(1, memory_order_acq_rel)==1){
             makeEmpty(t->left);
             makeEmpty(t->right);
-            delete t;
+            deleteNode(t);
         }
         t=nullptr;
     }
+
+/**
+ * Internal method to give this tree its own copy of node t, if t is shared.
+ * The copy shares the children of t, so they become shared in turn; insert()
+ * calls it on every node of its path before changing the node.
+ */
+AVL_TEMPLATE
+    void AVL_TREE::unshare(AvlNode<Comparable> *&t) const{
+        if(t->refs.load(memory_order_acquire)==1)
+            return;
+        AvlNode<Comparable> *copy=newNode(t->element, t->left, t->right,
+                                          t->height, t->size);
+        if(copy->left!=nullptr)
+            copy->left->refs.fetch_add(1, memory_order_relaxed);
+        if(copy->right!=nullptr)
+            copy->right->refs.fetch_add(1, memory_order_relaxed);
+        if(relocated)
+            relocated(&t->element, &copy->element);
+        makeEmpty(t);
+        t=copy;
+    }
     
 /**
  * Internal method to clone subtree.
  */
-template <class Comparable>
-    AvlNode<Comparable> *AvlTree<Comparable>::clone(AvlNode<Comparable> *t)
+AVL_TEMPLATE
+    AvlNode<Comparable> *AVL_TREE::clone(AvlNode<Comparable> *t)
                                                                         const{
         if(t==nullptr)
             return nullptr;
         else
-            return new AvlNode<Comparable>(t->element, clone(t->left),
-                                           clone(t->right), t->height);
+            return newNode(t->element, clone(t->left), clone(t->right),
+                           t->height, t->size);
     }
 
 /******************************Avl Manipulations*******************************/
@@ -306,48 +489,96 @@ template <class Comparable>
 /**
  * Return the height of node t, or -1, if NULL.
  */
-template <class Comparable>
-    int AvlTree<Comparable>::height(AvlNode<Comparable> *t) const{
+AVL_TEMPLATE
+    int AVL_TREE::height(AvlNode<Comparable> *t) const{
         return t==nullptr?-1:t->height;
     }
 
+/**
+ * Return the number of nodes in subtree t, or 0, if NULL.
+ */
+AVL_TEMPLATE
+    int AVL_TREE::size(const AvlNode<Comparable> *t) const{
+        return t==nullptr?0:t->size;
+    }
+
+/**
+ * Recompute the height and size of node t from its children.
+ */
+AVL_TEMPLATE
+    void AVL_TREE::update(AvlNode<Comparable> *t) const{
+        t->height=max(height(t->left), height(t->right))+1;
+        t->size=size(t->left)+size(t->right)+1;
+    }
+
+/**
+ * Restore the AVL balance of node t after a removal below it, then update it.
+ * The nodes a rotation changes are off the removal path, so they are
+ * unshared first.
+ */
+AVL_TEMPLATE
+    void AVL_TREE::balance(AvlNode<Comparable> *&t) const{
+        if(t==nullptr)
+            return;
+        if(height(t->left)-height(t->right)>1){
+            unshare(t->left);
+            if(height(t->left->left)>=height(t->left->right))
+                rotateWithLeftChild(t);
+            else{
+                unshare(t->left->right);
+                doubleWithLeftChild(t);
+            }
+        }
+        else if(height(t->right)-height(t->left)>1){
+            unshare(t->right);
+            if(height(t->right->right)>=height(t->right->left))
+                rotateWithRightChild(t);
+            else{
+                unshare(t->right->left);
+                doubleWithRightChild(t);
+            }
+        }
+        else
+            update(t);
+    }
+
 /**
  * Return maximum of lhs and rhs.
  */
-template <class Comparable>
-    int AvlTree<Comparable>::max(int lhs, int rhs) const{
+AVL_TEMPLATE
+    int AVL_TREE::max(int lhs, int rhs) const{
         return lhs>rhs?lhs:rhs;
     }
 
 /**
  * Rotate binary tree node with left child.
  * For AVL trees, this is a single rotation for case 1.
- * Update heights, then set new root.
+ * Update heights and sizes, then set new root.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::rotateWithLeftChild(AvlNode<Comparable> *&k2)
+AVL_TEMPLATE
+    void AVL_TREE::rotateWithLeftChild(AvlNode<Comparable> *&k2)
                                                                         const{
         AvlNode<Comparable> *k1=k2->left;
         k2->left=k1->right;
         k1->right=k2;
-        k2->height=max(height(k2->left), height(k2->right))+1;
-        k1->height=max(height(k1->left), k2->height)+1;
+        update(k2);
+        update(k1);
         k2=k1;
     }
 
 /**
  * Rotate binary tree node with right child.
  * For AVL trees, this is a single rotation for case 4.
- * Update heights, then set new root.
+ * Update heights and sizes, then set new root.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::rotateWithRightChild(AvlNode<Comparable> *&k1)
+AVL_TEMPLATE
+    void AVL_TREE::rotateWithRightChild(AvlNode<Comparable> *&k1)
                                                                         const{
         AvlNode<Comparable> *k2=k1->right;
         k1->right=k2->left;
         k2->left=k1;
-        k1->height=max(height(k1->left), height(k1->right))+1;
-        k2->height=max(height(k2->right), k1->height)+1;
+        update(k1);
+        update(k2);
         k1=k2;
     }
 
@@ -357,8 +588,8 @@ template <class Comparable>
  * For AVL trees, this is a double rotation for case 2.
  * Update heights, then set new root.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::doubleWithLeftChild(AvlNode<Comparable> *&k3)
+AVL_TEMPLATE
+    void AVL_TREE::doubleWithLeftChild(AvlNode<Comparable> *&k3)
                                                                         const{
         rotateWithRightChild(k3->left);
         rotateWithLeftChild(k3);
@@ -370,8 +601,8 @@ template <class Comparable>
  * For AVL trees, this is a double rotation for case 3.
  * Update heights, then set new root.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::doubleWithRightChild(AvlNode<Comparable> *&k1)
+AVL_TEMPLATE
+    void AVL_TREE::doubleWithRightChild(AvlNode<Comparable> *&k1)
                                                                         const{
         rotateWithLeftChild(k1->right);
         rotateWithRightChild(k1);
@@ -381,11 +612,12 @@ template <class Comparable>
  * Internal method to print a subtree in sorted order.
  * t points to the node that roots the tree.
  */
-template <class Comparable>
-    void AvlTree<Comparable>::printTree(AvlNode<Comparable> *t) const{
+AVL_TEMPLATE
+    void AVL_TREE::printTree(ostream &out, AvlNode<Comparable> *t)
+                                                                        const{
         if(t!=nullptr){
-            printTree(t->left);
-            cout<<t->element<<endl;
-            printTree(t->right);
+            printTree(out, t->left);
+            out<<t->element<<'\n';
+            printTree(out, t->right);
         }
     }
@@ -22,12 +22,41 @@ License         : Copyright 2020 Keisuke Suzuki, based on code written by
 #define _AVL_TREE_H_
 
 #include "../Tree/tree.h"
+#include "../Scheduler/task_scheduler.h"
+
+/** IdentityKey is the default key of an AvlTree: the item itself */
+template < class Comparable >
+    struct IdentityKey
+    {
+        const Comparable &operator()( const Comparable &x ) const
+        {
+            return x;
+        }
+    };
 
 // Node and forward declaration because g++ does
 // not understand nested classes.
-template < class Comparable >
+/** AvlTree<Comparable,KeyOf,Compare,Alloc> orders its items by
+ *  Compare()(KeyOf()(a), KeyOf()(b)). The policies are types, not function
+ *  pointers, so the compiler sees the comparison where it is used and can
+ *  inline it. They must be stateless: the tree makes a new one for each
+ *  use, and makes a new Alloc, rebound to its nodes, for each node.
+ */
+template < class Comparable,
+           class KeyOf = IdentityKey<Comparable>,
+           class Compare = less<>,
+           class Alloc = allocator<Comparable> >
     class AvlTree;
 
+// subtrees smaller than this are not worth a task of their own
+const int MIN_PARALLEL_SUBTREE=4096;
+
+/** forkDepth(n) returns how many levels of a tree of n nodes the scans
+ *  split into tasks: enough for a few tasks per worker, or none if the
+ *  current scheduler has only one worker.
+ */
+int forkDepth( int n );
+
 template < class Comparable >
     class AvlNode
     {
@@ -36,21 +65,36 @@ template < class Comparable >
         AvlNode *left;
         AvlNode *right;
         int height;
+        int size;       // number of nodes in the subtree rooted here
+        atomic<int> refs;   // number of trees and nodes that point here
         
         AvlNode( const Comparable &theElement,
                  AvlNode *lt,
                  AvlNode *rt,
-                 int h = 0 )
-        : element(theElement), left(lt), right(rt), height(h)
+                 int h = 0,
+                 int sz = 1 )
+        : element(theElement), left(lt), right(rt), height(h), size(sz),
+          refs(1)
         {
         }
         
-        friend class AvlTree<Comparable>;
+        AvlNode( Comparable &&theElement,
+                 AvlNode *lt,
+                 AvlNode *rt,
+                 int h = 0,
+                 int sz = 1 )
+        : element(std::move(theElement)), left(lt), right(rt), height(h),
+          size(sz), refs(1)
+        {
+        }
+        
+        template < class, class, class, class >
+            friend class AvlTree;
     };
 
 #include <iostream>
 
-template < class Comparable >
+template < class Comparable, class KeyOf, class Compare, class Alloc >
     class AvlTree
     {
         public:
@@ -67,18 +111,170 @@ template < class Comparable >
         
         const Comparable &find( const Comparable &x ) const;
         
-        list <Comparable> getSameZip( const Comparable &x ) const;
-        
-        list <Comparable> getCloseElem( const Comparable &x,
-                                        double distance ) const;
+        /** size() returns the number of items in the tree */
+        int size() const;
+        
+        /** nodeBytes() returns the heap memory the nodes of the tree take,
+         *  without what the items keep on the heap themselves. Nodes that
+         *  are shared with snapshots are counted as well.
+         */
+        size_t nodeBytes() const;
+        
+        /** rank(x) returns the number of items that are less than x, which is
+         *  the position x has or would have in sorted order.
+         */
+        int rank( const Comparable &x ) const;
+        
+        /** select(k) returns the item at position k in sorted order,
+         *  counting from 0, or ITEM_NOT_FOUND if k is out of range.
+         */
+        const Comparable &select( int k ) const;
+        
+        /** countRange(lo,hi) returns the number of items x with lo <= x <= hi
+         */
+        int countRange( const Comparable &lo, const Comparable &hi ) const;
+        
+        /** findIf(match) returns the items for which match(item) is true,
+         *  in sorted order, as pointers into the nodes. Nothing is copied;
+         *  the pointers stay valid until the tree is changed, or as long as
+         *  a snapshot of it is kept. The top levels of a large tree are
+         *  scanned in parallel, so match is called from several threads.
+         */
+        template < class Predicate >
+            vector <const Comparable *> findIf( Predicate match ) const
+            {
+                vector<const Comparable *> found;
+                collect(root, match, forkDepth(size()), found);
+                return found;
+            }
         
         bool isEmpty() const;
         
-        void printTree() const;
+        void printTree( ostream &out = cout ) const;
         
         void makeEmpty();
         
-        void insert( const Comparable &x );
+        const Comparable *insert( const Comparable &x );
+        
+        /** insert(x) with an rvalue moves x into its new node instead of
+         *  copying it; x is left as it was if an equal item is already there
+         */
+        const Comparable *insert( Comparable &&x );
+        
+        /** emplace(args) inserts Comparable(args), moved into its node
+         *  @return the address of the stored item, as insert() does
+         */
+        template < class... Args >
+            const Comparable *emplace( Args &&... args )
+            {
+                return insert(Comparable(std::forward<Args>(args)...));
+            }
+        
+        /** remove(x) removes the item equal to x, if there is one. The
+         *  item that takes its node moves; onRelocate() reports the move.
+         *  @return bool true if an item was removed
+         */
+        bool remove( const Comparable &x );
+        
+        /** modify(x,f) calls f(item) on the item equal to x, which f may
+         *  change in any way that keeps it equal to x. Shared nodes on the
+         *  way are copied first, as insert() does.
+         *  @return bool false if there is no such item
+         */
+        template < class Modifier >
+            bool modify( const Comparable &x, Modifier f )
+            {
+                if(find(x, root) == nullptr)
+                    return false;
+                AvlNode<Comparable> **link = &root;
+                while(true)
+                {
+                    unshare(*link);
+                    AvlNode<Comparable> *t = *link;
+                    if(less(x, t->element))
+                        link = &t->left;
+                    else if(less(t->element, x))
+                        link = &t->right;
+                    else
+                    {
+                        f(t->element);
+                        return true;
+                    }
+                }
+            }
+        
+        /** snapshot() returns a read-only copy of the tree in O(1). The copy
+         *  shares every node with this tree, and from then on insert()
+         *  copies each shared node on its path (path copying) instead of
+         *  changing it, so the snapshot never sees later insertions.
+         *  Nodes are freed when the last tree that shares them is gone.
+         *  Call it from the thread that inserts; other threads should get
+         *  their snapshots through a SnapshotSlot.
+         */
+        shared_ptr<const AvlTree> snapshot() const;
+        
+        /** share() returns the same kind of copy as snapshot(), by value,
+         *  for owners that keep their tree as a member
+         */
+        AvlTree share() const;
+        
+        /** onRelocate(f) makes insert() call f(from,to) whenever it copies a
+         *  shared node, so that users of the addresses insert() returned can
+         *  follow the item from its old node to its new one.
+         */
+        void onRelocate( function<void( const Comparable *,
+                                        const Comparable * )> f );
+        
+        /** forEach(f) calls f(element) on every item in sorted order.
+         *  The walk is iterative, so it does not depend on the tree height.
+         */
+        template < class Visitor >
+            void forEach( Visitor f ) const
+            {
+                forEach(0, size(), f);
+            }
+        
+        /** forEach(offset,limit,f) calls f(element) on at most limit items in
+         *  sorted order, starting at position offset. The start is found by
+         *  subtree sizes, so the cost is O(log n + limit).
+         */
+        template < class Visitor >
+            void forEach( int offset, int limit, Visitor f ) const
+            {
+                vector<const AvlNode<Comparable> *> path;
+                const AvlNode<Comparable> *t = root;
+                while(t != nullptr)
+                {
+                    int left_size = size(t->left);
+                    if(offset < left_size)
+                    {
+                        path.push_back(t);
+                        t = t->left;
+                    }
+                    else if(offset == left_size)
+                    {
+                        path.push_back(t);
+                        t = nullptr;
+                    }
+                    else
+                    {
+                        offset -= left_size + 1;
+                        t = t->right;
+                    }
+                }
+                for(; limit > 0 && (t != nullptr || ! path.empty()); limit --)
+                {
+                    while(t != nullptr)
+                    {
+                        path.push_back(t);
+                        t = t->left;
+                    }
+                    t = path.back();
+                    path.pop_back();
+                    f(t->element);
+                    t = t->right;
+                }
+            }
         
         const AvlTree &operator=( const AvlTree &rhs );
         
@@ -88,9 +284,55 @@ template < class Comparable >
         
         const Comparable ITEM_NOT_FOUND;
         
+        function<void( const Comparable *, const Comparable * )> relocated;
+        
+        typedef typename allocator_traits<Alloc>::template
+            rebind_alloc<AvlNode<Comparable>> NodeAlloc;
+        typedef allocator_traits<NodeAlloc> NodeTraits;
+        
+        struct Share {};
+        
+        AvlTree( const AvlTree &rhs, Share );
+        
+        bool less( const Comparable &lhs, const Comparable &rhs ) const
+        {
+            return Compare()(KeyOf()(lhs), KeyOf()(rhs));
+        }
+        
+        template < class... Args >
+            AvlNode<Comparable> *newNode( Args &&... args ) const
+            {
+                NodeAlloc alloc;
+                AvlNode<Comparable> *t = NodeTraits::allocate(alloc, 1);
+                try
+                {
+                    new(t) AvlNode<Comparable>(std::forward<Args>(args)...);
+                }
+                catch(...)
+                {
+                    NodeTraits::deallocate(alloc, t, 1);
+                    throw;
+                }
+                return t;
+            }
+        
+        void deleteNode( AvlNode<Comparable> *t ) const
+        {
+            NodeAlloc alloc;
+            t->~AvlNode<Comparable>();
+            NodeTraits::deallocate(alloc, t, 1);
+        }
+        
         const Comparable &elementAt( AvlNode<Comparable> *t ) const;
         
-        void insert( const Comparable &x, AvlNode<Comparable> *&t ) const;
+        template < class Item >
+            void insert( Item &&x, AvlNode<Comparable> *&t,
+                         const Comparable *&stored ) const;
+        
+        void remove( const Comparable &x, AvlNode<Comparable> *&t,
+                     bool &removed ) const;
+        
+        AvlNode<Comparable> *detachMin( AvlNode<Comparable> *&t ) const;
         
         AvlNode<Comparable> *findMin( AvlNode<Comparable> *t ) const;
         
@@ -99,23 +341,54 @@ template < class Comparable >
         AvlNode<Comparable> *find( const Comparable &x, AvlNode<Comparable> *t )
         const;
         
-        list <Comparable> getSameZip( const Comparable &x,
-                                      AvlNode<Comparable>
-                                      *t ) const;
-        
-        list <Comparable> getCloseElem( const Comparable &x,
-                                        AvlNode<Comparable> *t, double
-                                        distance ) const;
+        /** collect(t,match,depth,found) appends the items of t that match
+         *  to found, in sorted order. The two subtrees of the top depth
+         *  levels are scanned in parallel, the right one into a vector of
+         *  its own that is appended after the left one.
+         */
+        template < class Predicate >
+            void collect( const AvlNode<Comparable> *t, Predicate &match,
+                          int depth, vector<const Comparable *> &found ) const
+            {
+                if(t == nullptr)
+                    return;
+                if(depth > 0 && size(t) >= MIN_PARALLEL_SUBTREE)
+                {
+                    vector<const Comparable *> right_found;
+                    parallel_invoke(
+                        [&]{ collect(t->left, match, depth-1, found); },
+                        [&]{ collect(t->right, match, depth-1, right_found); });
+                    if(match(t->element))
+                        found.push_back(&t->element);
+                    found.insert(found.end(), right_found.begin(),
+                                 right_found.end());
+                }
+                else
+                {
+                    collect(t->left, match, 0, found);
+                    if(match(t->element))
+                        found.push_back(&t->element);
+                    collect(t->right, match, 0, found);
+                }
+            }
         
         void makeEmpty( AvlNode<Comparable> *&t ) const;
         
-        void printTree( AvlNode<Comparable> *t ) const;
+        void unshare( AvlNode<Comparable> *&t ) const;
+        
+        void printTree( ostream &out, AvlNode<Comparable> *t ) const;
         
         AvlNode<Comparable> *clone( AvlNode<Comparable> *t ) const;
         
         // Avl manipulations
         int height( AvlNode<Comparable> *t ) const;
         
+        int size( const AvlNode<Comparable> *t ) const;
+        
+        void update( AvlNode<Comparable> *t ) const;
+        
+        void balance( AvlNode<Comparable> *&t ) const;
+        
         int max( int lhs, int rhs ) const;
         
         void rotateWithLeftChild( AvlNode<Comparable> *&k2 ) const;
@@ -0,0 +1,62 @@
+/*******************************************************************************
+Title           : packed_key.h
+Created on      : Oct 19, 2026
+Description     : Interface and implementation of the PackedTreeRef and
+                  PackedCount keys
+Purpose         : Files trees in an AvlTree under one 64-bit integer instead
+                  of their names, so that each step down the tree is a single
+                  integer compare that the compiler inlines
+*******************************************************************************/
+
+#ifndef SW2_PACKED_KEY_H_
+#define SW2_PACKED_KEY_H_
+
+#include "../Tree/tree.h"
+
+using namespace std;
+
+/** pack_tree_key(species,id) packs a species number into the high 32 bits
+ *  and a census id into the low 32. If the species are numbered in the
+ *  order of their names, the keys sort as the trees do.
+ */
+inline uint64_t pack_tree_key(uint32_t species, int id){
+    return (uint64_t)species<<32|(uint32_t)id;
+}
+
+/** PackedTreeRef is a tree kept elsewhere, filed under its packed key */
+struct PackedTreeRef{
+    uint64_t key;
+    const Tree *tree;
+};
+
+/** PackedCount is a count filed under a packed key, such as the number of
+ *  trees of one species in one cell of a grid
+ */
+struct PackedCount{
+    uint64_t key;
+    uint32_t count;
+};
+
+/** PackedKeyOf is the KeyOf policy of an AvlTree of PackedTreeRef or of
+ *  PackedCount
+ */
+struct PackedKeyOf{
+    template <class Packed>
+        uint64_t operator()(const Packed &item) const{
+            return item.key;
+        }
+};
+
+/** operator<<(os,ref) writes the tree ref files, for AvlTree::printTree */
+inline ostream &operator <<(ostream &os, const PackedTreeRef &ref){
+    if(ref.tree!=nullptr)
+        os<<*ref.tree;
+    return os;
+}
+
+/** operator<<(os,c) writes the key and the count of c */
+inline ostream &operator <<(ostream &os, const PackedCount &c){
+    return os<<c.key<<": "<<c.count;
+}
+
+#endif //SW2_PACKED_KEY_H_
@@ -0,0 +1,85 @@
+/**
+    diversity.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement diversity class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "diversity.h"
+#include "../Heatmap/density_pyramid.h"
+
+/****************************Helper Functions**********************************/
+
+//sets the counts and indices of d from the counts of its species
+void measure(const vector<long> &species_counts, Diversity &d){
+    d.trees=0;
+    for(long n:species_counts)
+        d.trees+=n;
+    d.species=species_counts.size();
+    d.shannon=0;
+    double squares=0;
+    for(long n:species_counts){
+        double p=(double)n/d.trees;
+        d.shannon-=p*log(p);
+        squares+=p*p;
+    }
+    d.simpson=1-squares;
+}
+
+/****************************DiversityTally Class******************************/
+
+DiversityTally::DiversityTally(int cell_m):
+    scale(cell_m/DensityPyramid::BASE_CELL_M),
+    side(scale>0?(DensityPyramid::BASE_SIDE+scale-1)/scale:0){}
+
+void DiversityTally::add(int zipcode, uint32_t species){
+    keys.push_back((uint64_t)(uint32_t)zipcode<<32|species);
+}
+
+void DiversityTally::add(double lat, double lon, uint32_t species){
+    int x, y;
+    if(DensityPyramid::base_cell(lat, lon, x, y))
+        keys.push_back((uint64_t)((y/scale)*side+x/scale)<<32|species);
+}
+
+void DiversityTally::merge(const DiversityTally &other){
+    keys.insert(keys.end(), other.keys.begin(), other.keys.end());
+}
+
+vector<Diversity> DiversityTally::regions() const{
+    vector<uint64_t> sorted(keys);
+    sort(sorted.begin(), sorted.end());
+    vector<Diversity> result;
+    vector<long> species_counts;
+    for(size_t i=0; i<sorted.size(); ){
+        uint32_t region=sorted[i]>>32;
+        species_counts.clear();
+        while(i<sorted.size() && sorted[i]>>32==region){
+            size_t j=i;
+            while(j<sorted.size() && sorted[j]==sorted[i])
+                j++;
+            species_counts.push_back(j-i);
+            i=j;
+        }
+        Diversity d{scale>0, 0, 0, 0, 0, 0, 0, 0};
+        if(d.by_cell){
+            d.x=region%side;
+            d.y=region/side;
+        }
+        else
+            d.zipcode=(int)region;
+        measure(species_counts, d);
+        result.push_back(d);
+    }
+    return result;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+Title           : diversity.h
+Created on      : Oct 19, 2026
+Description     : Interface of the Diversity record and the DiversityTally
+                  class
+Purpose         : Counts the trees of each species in each zip code or grid
+                  cell in one pass, in parts that can be counted in parallel
+                  and merged, and gives the Shannon and Simpson indices of
+                  every region from the counts
+*******************************************************************************/
+
+#ifndef SW2_DIVERSITY_H_
+#define SW2_DIVERSITY_H_
+
+using namespace std;
+
+/** Diversity is how diverse the trees of one region are: a zip code, or if
+ *  by_cell is true the cell in column x and row y of a grid of
+ *  DensityPyramid. shannon is -sum(p ln p) and simpson is 1 - sum(p^2),
+ *  the chance that two trees picked at random are of different species,
+ *  over the shares p of the species among the trees.
+ */
+struct Diversity{
+    bool by_cell;
+    int zipcode;
+    int x, y;
+    long trees;
+    int species;
+    double shannon;
+    double simpson;
+};
+
+/** class DiversityTally counts trees by region and species. Species are
+ *  numbered as in HotTrees. A tally of cells only counts the trees inside
+ *  the grid, as heatmap does. It keeps a key of the region and species of
+ *  each tree, which regions() sorts and counts in runs; with tens of
+ *  thousands of cells that is faster than a count per key in a hash table.
+ */
+class DiversityTally{
+    public:
+
+    /** DiversityTally(cell_m) starts a tally by zip code if cell_m is 0, or
+     *  by cells of cell_m meters
+     *  @pre cell_m is 0 or DensityPyramid::valid_cell_size(cell_m)
+     */
+    explicit DiversityTally(int cell_m);
+
+    /** add(zipcode,s) counts a tree of species s in a tally by zip code */
+    void add(int zipcode, uint32_t species);
+
+    /** add(lat,lon,s) counts a tree of species s at (lat,lon) in a tally by
+     *  cells
+     */
+    void add(double lat, double lon, uint32_t species);
+
+    /** merge(other) adds the counts of other, a tally of the same regions */
+    void merge(const DiversityTally &other);
+
+    /** regions() returns the regions with trees, in the order of their zip
+     *  codes or row by row from the south west corner
+     */
+    vector<Diversity> regions() const;
+
+    private:
+
+    int scale;      // base cells on a side of a cell, 0 for zip codes
+    int side;       // cells on a side of the grid
+    vector<uint64_t> keys;  // region<<32|species of each tree
+};
+
+#endif //SW2_DIVERSITY_H_
@@ -0,0 +1,162 @@
+/**
+    nearest_neighbors.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement nearest_neighbors class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "nearest_neighbors.h"
+#include "../GPS/gps.h"
+#include "../Scheduler/task_scheduler.h"
+
+const double POINTS_PER_CELL=2;
+const double SMALLEST_STEP=1e-6;    // degrees, about 0.1 m
+const int32_t LAST_LINE=1<<30;      // cells past it are filed with it
+
+/****************************Helper Functions**********************************/
+
+//sets first and last to the ends of the middle 98% of the values, so that
+//a few points far away do not make the cells too large
+void middle_range(vector<double> values, double &first, double &last){
+    size_t low=values.size()/100, high=values.size()-1-low;
+    nth_element(values.begin(), values.begin()+low, values.end());
+    first=values[low];
+    nth_element(values.begin(), values.begin()+high, values.end());
+    last=values[high];
+}
+
+/****************************PointGrid Class***********************************/
+
+PointGrid::PointGrid(const vector<pair<double, double>> &_points):
+    points(_points), south(0), west(0), lat_step(1), lon_step(1), rows(0),
+    columns(0){
+    vector<double> lats, lons;
+    for(const auto &p:points)
+        if(isfinite(p.first) && isfinite(p.second)){
+            lats.push_back(p.first);
+            lons.push_back(p.second);
+        }
+    if(lats.empty())
+        return;
+    south=*min_element(lats.begin(), lats.end());
+    west=*min_element(lons.begin(), lons.end());
+    double lat_lo, lat_hi, lon_lo, lon_hi;
+    middle_range(lats, lat_lo, lat_hi);
+    middle_range(lons, lon_lo, lon_hi);
+    double area=max(lat_hi-lat_lo, SMALLEST_STEP)*
+                max(lon_hi-lon_lo, SMALLEST_STEP);
+    double step=max(sqrt(area*POINTS_PER_CELL/lats.size()), SMALLEST_STEP);
+    //a degree of longitude is shorter than one of latitude, so cells as
+    //long as the box of a distance is wide keep the boxes small
+    double lat_span, lon_span;
+    great_circle_bounds((lat_lo+lat_hi)/2, 1, lat_span, lon_span);
+    double aspect=isfinite(lat_span) && isfinite(lon_span)?
+                  min(max(lat_span/lon_span, 0.01), 100.0):1;
+    lat_step=max(step*sqrt(aspect), SMALLEST_STEP);
+    lon_step=max(step/sqrt(aspect), SMALLEST_STEP);
+
+    filed.reserve(points.size());
+    for(uint32_t i=0; i<points.size(); i++){
+        int32_t row=line(points[i].first, south, lat_step);
+        int32_t column=line(points[i].second, west, lon_step);
+        rows=max(rows, row+1);
+        columns=max(columns, column+1);
+        filed.push_back({key(row, column), i});
+    }
+    sort(filed.begin(), filed.end());
+}
+
+size_t PointGrid::size() const{
+    return points.size();
+}
+
+double PointGrid::nearest(size_t i) const{
+    double lat=points[i].first, lon=points[i].second;
+    //start with a box of about one cell around the point
+    double distance=max(great_circle(lat, lon, lat+lat_step, lon),
+                        great_circle(lat, lon, lat, lon+lon_step));
+    if(!(distance>0))
+        distance=SMALLEST_STEP;
+    double best=INFINITY;
+    for(;;){
+        double lat_span, lon_span;
+        great_circle_bounds(lat, distance, lat_span, lon_span);
+        int32_t y0=line(lat-lat_span, south, lat_step);
+        int32_t y1=min(line(lat+lat_span, south, lat_step), rows-1);
+        int32_t x0=line(lon-lon_span, west, lon_step);
+        int32_t x1=min(line(lon+lon_span, west, lon_step), columns-1);
+        for(int32_t y=y0; y<=y1; y++){
+            auto it=lower_bound(filed.begin(), filed.end(),
+                                make_pair(key(y, x0), uint32_t(0)));
+            for(; it!=filed.end() && it->first<=key(y, x1); ++it)
+                if(it->second!=i){
+                    const auto &p=points[it->second];
+                    best=min(best, great_circle(lat, lon, p.first,
+                                                p.second));
+                }
+        }
+        //every point within distance is in the box, so a point found
+        //within it is the nearest; past every cell there is nothing more
+        bool everything=y0==0 && x0==0 && y1==rows-1 && x1==columns-1;
+        if(best<=distance || everything || isinf(distance))
+            return best;
+        distance=isinf(best)?distance*2:best;
+    }
+}
+
+vector<double> PointGrid::all_nearest() const{
+    vector<double> result(points.size());
+    parallel_for(0, points.size(), NEAREST_GRAIN, [&](size_t lo, size_t hi){
+        for(size_t i=lo; i<hi; i++)
+            result[i]=nearest(i);
+    });
+    return result;
+}
+
+//the cell degrees are in along a line from origin, cells of step degrees,
+//cut to [0,LAST_LINE]; the cut keeps the order, so a box still holds the
+//cells of its points
+int32_t PointGrid::line(double degrees, double origin, double step) const{
+    double cell=floor((degrees-origin)/step);
+    if(!(cell>0))
+        return 0;
+    return cell<LAST_LINE?(int32_t)cell:LAST_LINE;
+}
+
+/****************************Statistics****************************************/
+
+NearestStats nearest_stats(vector<double> distances){
+    NearestStats stats{(long)distances.size(), 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    distances.erase(remove_if(distances.begin(), distances.end(),
+                              [](double d){ return !isfinite(d); }),
+                    distances.end());
+    if(distances.empty())
+        return stats;
+    for(double &d:distances)
+        d*=1000;
+    sort(distances.begin(), distances.end());
+    size_t n=distances.size();
+    auto at=[&distances, n](double share){
+        return distances[(size_t)llround(share*(n-1))];
+    };
+    stats.paired=n;
+    stats.mean=accumulate(distances.begin(), distances.end(), 0.0)/n;
+    stats.min=distances.front();
+    stats.p10=at(0.10);
+    stats.p25=at(0.25);
+    stats.median=at(0.50);
+    stats.p75=at(0.75);
+    stats.p90=at(0.90);
+    stats.max=distances.back();
+    return stats;
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+Title           : nearest_neighbors.h
+Created on      : Oct 19, 2026
+Description     : Interface of the PointGrid class and the NearestStats
+                  record
+Purpose         : Finds, for each of a set of points, the distance to the
+                  nearest other point of the set by looking only at the
+                  grid cells around it, instead of measuring every pair
+*******************************************************************************/
+
+#ifndef SW2_NEAREST_NEIGHBORS_H_
+#define SW2_NEAREST_NEIGHBORS_H_
+
+using namespace std;
+
+/** NearestStats sums up the distances in meters from trees to their
+ *  nearest neighbors: of trees, the paired ones have a neighbor, and the
+ *  statistics are over the distances of those. The percentiles are the
+ *  distances at that share of the sorted distances, rounded to the
+ *  nearest one.
+ */
+struct NearestStats{
+    long trees;
+    long paired;
+    double mean;
+    double min;
+    double p10;
+    double p25;
+    double median;
+    double p75;
+    double p90;
+    double max;
+};
+
+/** class PointGrid files points, given as (latitude,longitude), in cells
+ *  sized for about two points each, and shaped like the box of degrees
+ *  great_circle_bounds() gives in the middle of the points. nearest()
+ *  searches the cells of the box great_circle_bounds() gives around a
+ *  point, and doubles the distance until a point turns up within it, so
+ *  that the answer is the one great_circle() would give if every point
+ *  were measured. Distances are real great-circle ones, not those of
+ *  distance_between(), which list_near keeps for its output's sake.
+ */
+class PointGrid{
+    public:
+
+    explicit PointGrid(const vector<pair<double, double>> &points);
+
+    size_t size() const;
+
+    /** nearest(i) returns the distance in km from point i to the nearest
+     *  other point, or INFINITY if there is none
+     */
+    double nearest(size_t i) const;
+
+    /** all_nearest() returns nearest(i) of every point, found in parallel */
+    vector<double> all_nearest() const;
+
+    private:
+
+    static const size_t NEAREST_GRAIN=1024;
+
+    vector<pair<double, double>> points;
+    double south, west;         // the corner of cell (0,0)
+    double lat_step, lon_step;  // degrees on the sides of a cell
+    int32_t rows, columns;      // the cells reached by the points
+    vector<pair<uint64_t, uint32_t>> filed;   // cell key and point, sorted
+
+    int32_t line(double degrees, double origin, double step) const;
+
+    static uint64_t key(int32_t row, int32_t column){
+        return (uint64_t)row<<32|(uint32_t)column;
+    }
+};
+
+/** nearest_stats(distances) sums up distances in km, INFINITY for the
+ *  trees without a neighbor, as NearestStats in meters
+ */
+NearestStats nearest_stats(vector<double> distances);
+
+#endif //SW2_NEAREST_NEIGHBORS_H_
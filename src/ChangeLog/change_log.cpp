@@ -0,0 +1,163 @@
+/**
+    change_log.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement change_log class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "change_log.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/****************************Helper Functions**********************************/
+
+int apply_change(TreeCollection &trees, const Command &change){
+    string field, value;
+    change.get_change(field, value);
+    switch(change.type_of()){
+        case add_tree_cmmd:{
+            Tree new_tree(value);
+            return new_tree.id()==0?0:trees.add_tree(move(new_tree));
+        }
+        case update_tree_cmmd:
+            return max(0, trees.update_trees(change.tree_id(), field, value));
+        case delete_tree_cmmd:return trees.remove_trees(change.tree_id());
+        default:return 0;
+    }
+}
+
+//writes all of s to fd and then to the disk
+bool write_durably(int fd, const string &s){
+    for(size_t done=0; done<s.size();){
+        ssize_t n=write(fd, s.data()+done, s.size()-done);
+        if(n<0 && errno==EINTR)
+            continue;
+        if(n<=0)
+            return false;
+        done+=n;
+    }
+    return fsync(fd)==0;
+}
+
+//writes the directory entries of the directory holding file_path to the
+//disk, so that a rename into it survives a crash
+bool sync_directory(const string &file_path){
+    size_t slash=file_path.rfind('/');
+    string directory=slash==string::npos?".":
+                     slash==0?"/":file_path.substr(0, slash);
+    int dir_fd=open(directory.c_str(), O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+    if(dir_fd<0)
+        return false;
+    bool synced=fsync(dir_fd)==0;
+    close(dir_fd);
+    return synced;
+}
+
+/****************************ChangeLog Class***********************************/
+
+ChangeLog::ChangeLog(TreeCollection &_trees, const string &_path,
+                     long _compact_every): trees(_trees), path(_path),
+                     compact_every(max(_compact_every, 1L)), entries(0),
+                     fd(-1){}
+
+ChangeLog::~ChangeLog(){
+    if(fd>=0)
+        close(fd);
+}
+
+string ChangeLog::snapshot_path() const{
+    return path+".snapshot";
+}
+
+long ChangeLog::replay(){
+    ifstream in(path, ios::binary);
+    string line;
+    long line_number=0;
+    off_t good_size=0;
+
+    entries=0;
+    while(getline(in, line)){
+        if(in.eof())
+            break;      //no '\n': the write of this line never finished
+        line_number++;
+        good_size+=line.size()+1;
+        istringstream iss(line+"\n");
+        Command change;
+        //a line that does not parse is skipped, not allowed to end the
+        //replay of the lines after it
+        bool valid;
+        try{
+            valid=change.get_next(iss) &&
+                  (change.type_of()==add_tree_cmmd ||
+                   change.type_of()==update_tree_cmmd ||
+                   change.type_of()==delete_tree_cmmd);
+            if(valid)
+                apply_change(trees, change);
+        }
+        catch(const exception &){
+            valid=false;
+        }
+        if(!valid){
+            cerr<<"bad change on line "<<line_number<<" of "<<path<<endl;
+            continue;
+        }
+        entries++;
+    }
+    in.close();
+
+    fd=open(path.c_str(), O_WRONLY|O_CREAT|O_APPEND|O_CLOEXEC, 0644);
+    if(fd<0 || ftruncate(fd, good_size)!=0){
+        cerr<<"Could not open change log "<<path<<": "<<strerror(errno)
+            <<endl;
+        return -1;
+    }
+    return entries;
+}
+
+int ChangeLog::apply(const Command &change){
+    if(fd<0 || !write_durably(fd, change.change_text()+"\n"))
+        return -1;
+    int changed=apply_change(trees, change);
+    if(++entries>=compact_every && !compact())
+        cerr<<"Could not compact change log "<<path<<endl;
+    return changed;
+}
+
+bool ChangeLog::compact(){
+    string temp_path=snapshot_path()+".tmp";
+    {
+        ofstream out(temp_path, ios::binary|ios::trunc);
+        if(out.fail())
+            return false;
+        trees.write_data_file(out);
+        out.flush();
+        if(out.fail())
+            return false;
+    }
+    //make the snapshot durable before it replaces the old one
+    int snapshot_fd=open(temp_path.c_str(), O_RDONLY|O_CLOEXEC);
+    bool synced=snapshot_fd>=0 && fsync(snapshot_fd)==0;
+    if(snapshot_fd>=0)
+        close(snapshot_fd);
+    if(!synced || rename(temp_path.c_str(), snapshot_path().c_str())!=0)
+        return false;
+    //the log may only be emptied once the new snapshot's name is on disk;
+    //otherwise a crash could leave the old snapshot next to an empty log
+    if(!sync_directory(snapshot_path()))
+        return false;
+    if(fd<0 || ftruncate(fd, 0)!=0 || fsync(fd)!=0)
+        return false;
+    entries=0;
+    return true;
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+Title           : change_log.h
+Created on      : Oct 19, 2026
+Description     : Interface of the ChangeLog class
+Purpose         : Applies census updates to a loaded collection and keeps
+                  them in a write-ahead log, so that a restart is a snapshot
+                  load plus a log replay instead of a full reload
+*******************************************************************************/
+
+#ifndef SW2_CHANGE_LOG_H_
+#define SW2_CHANGE_LOG_H_
+
+#include "../Command/command.h"
+#include "../TreeCollection/tree_collection.h"
+
+using namespace std;
+
+/** apply_change(trees,c) applies the add_tree, update_tree or delete_tree
+ *  command c to trees
+ *  @return int the number of trees changed
+ */
+int apply_change(TreeCollection &trees, const Command &change);
+
+/** class ChangeLog keeps the change commands applied to a collection in an
+ *  append-only file, one command per line, in the form of the command file.
+ *  Each change is written to disk before it is applied. Once the log holds
+ *  compact_every changes, the whole collection is written to the snapshot
+ *  file, path + ".snapshot", in the format of the data file, and the log is
+ *  emptied. Replaying a log over a snapshot that already has its changes
+ *  gives the same trees, so a crash between the two steps loses nothing.
+ */
+class ChangeLog{
+    public:
+    
+    static const long COMPACT_EVERY=10000;
+    
+    ChangeLog(TreeCollection &trees, const string &path,
+              long compact_every=COMPACT_EVERY);
+    
+    ChangeLog(const ChangeLog &)=delete;
+    
+    ChangeLog &operator =(const ChangeLog &)=delete;
+    
+    ~ChangeLog();
+    
+    /** snapshot_path() returns the file compact() writes; load it instead
+     *  of the original data file when it exists
+     */
+    string snapshot_path() const;
+    
+    /** replay() applies the changes in the log to the collection and opens
+     *  the log for appending. A last line cut short by a crash is dropped.
+     *  @return long the number of changes replayed, or -1 if the log could
+     *          not be opened
+     */
+    long replay();
+    
+    /** apply(c) writes change command c to the log, then applies it
+     *  @return int the number of trees changed, or -1 if the log could not
+     *          be written, in which case nothing is changed
+     */
+    int apply(const Command &change);
+    
+    /** compact() writes the collection to the snapshot file and empties the
+     *  log once the snapshot and its directory entry are on disk
+     *  @return bool false if a file could not be written or synced; the log
+     *               is only emptied if the snapshot replaced the old one
+     *               durably
+     */
+    bool compact();
+    
+    private:
+    
+    TreeCollection &trees;
+    string path;
+    long compact_every;
+    long entries;
+    int fd;
+};
+
+#endif //SW2_CHANGE_LOG_H_
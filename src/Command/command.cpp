@@ -24,6 +24,9 @@ License        : Copyright 2020 Keisuke Suzuki, based on code written by
 
 
 #include "command.h"
+#include "../Tree/tree.h"
+#include "../Polygon/polygon.h"
+#include "../Heatmap/density_pyramid.h"
 
 #define MAXBUF 4096
 
@@ -127,15 +130,201 @@ bool Command::get_next( istream &in )
                 die(" Distance argument for list_near command is negative");
                 return false;
             }
+            
+            string word;
+            this->mode = exact_near;
+            if(iss >> word)
+            {
+                if(word == "approximate")
+                    this->mode = approximate_near;
+                else if(word == "estimate")
+                    this->mode = estimate_near;
+                else
+                {
+                    std::cerr << line << ": ";
+                    die(" list_near takes approximate or estimate after the"
+                        " distance");
+                    return false;
+                }
+            }
         }
         else if(first_word == "print_all")
         {
             this->type = print_all_cmmd;
+            this->offset = 0;
+            this->limit = - 1;
+            if(iss >> this->offset)
+            {
+                iss >> this->limit;
+                if(! iss || this->offset < 0 || this->limit < 0)
+                {
+                    std::cerr << line << ": ";
+                    die(" print_all takes a non-negative offset and limit");
+                    return false;
+                }
+            }
         }
         else if(first_word == "remove_stumps")
         {
             this->type = remove_stumps_cmmd;
         }
+        else if(first_word == "tree_by_id")
+        {
+            iss >> this->id;
+            if(! iss)
+            {
+                std::cerr << line << ": ";
+                die(" Missing tree id for tree_by_id command");
+                return false;
+            }
+            this->type = tree_by_id_cmmd;
+        }
+        else if(first_word == "add_tree")
+        {
+            getline(iss >> ws, this->value);
+            bool valid;
+            try
+            {
+                valid = Tree(this->value).id() != 0;
+            }
+            catch(const exception &)
+            {
+                valid = false;
+            }
+            if(! valid)
+            {
+                std::cerr << line << ": ";
+                die(" add_tree needs a valid row of the data file");
+                return false;
+            }
+            this->field.clear();
+            this->type = add_tree_cmmd;
+        }
+        else if(first_word == "update_tree")
+        {
+            iss >> this->id >> this->field >> this->value;
+            Tree probe;
+            if(! iss || ! ((this->field == "status" &&
+                            probe.set_status(this->value)) ||
+                           (this->field == "health" &&
+                            probe.set_health(this->value)) ||
+                           (this->field == "dbh" && this->value.size() < 10 &&
+                            this->value.find_first_not_of("0123456789") ==
+                            string::npos)))
+            {
+                std::cerr << line << ": ";
+                die(" update_tree takes an id, then status, health or dbh"
+                    " and a valid value");
+                return false;
+            }
+            this->type = update_tree_cmmd;
+        }
+        else if(first_word == "delete_tree")
+        {
+            iss >> this->id;
+            if(! iss)
+            {
+                std::cerr << line << ": ";
+                die(" Missing tree id for delete_tree command");
+                return false;
+            }
+            this->type = delete_tree_cmmd;
+        }
+        else if(first_word == "memory_report")
+        {
+            this->type = memory_report_cmmd;
+        }
+        else if(first_word == "list_in_box")
+        {
+            iss >> latitude >> longitude >> latitude2 >> longitude2;
+            if(! iss)
+            {
+                std::cerr << line << ": ";
+                die(" list_in_box takes the latitude and longitude of two"
+                    " corners");
+                return false;
+            }
+            if((latitude <= - 90) || (latitude >= 90) ||
+               (latitude2 <= - 90) || (latitude2 >= 90))
+            {
+                die(" Latitude must be in range (-90,90)");
+                return false;
+            }
+            if((longitude < - 180) || (longitude > 180) ||
+               (longitude2 < - 180) || (longitude2 > 180))
+            {
+                die(" Longitude must be in range [-180,180]");
+                return false;
+            }
+            this->type = list_in_box_cmmd;
+        }
+        else if(first_word == "list_in_polygon")
+        {
+            getline(iss >> ws, this->path);
+            this->path.erase(this->path.find_last_not_of(" \t\r") + 1);
+            ifstream wkt(this->path);
+            ostringstream text;
+            text << wkt.rdbuf();
+            shared_ptr<Polygon> polygon = make_shared<Polygon>();
+            if(this->path.empty() || ! wkt || ! polygon->read_wkt(text.str()))
+            {
+                std::cerr << line << ": ";
+                die(" list_in_polygon needs a file with a WKT POLYGON or"
+                    " MULTIPOLYGON");
+                return false;
+            }
+            this->shape = polygon;
+            this->type = list_in_polygon_cmmd;
+        }
+        else if(first_word == "heatmap")
+        {
+            iss >> this->cell_m;
+            if(! iss || ! DensityPyramid::valid_cell_size(this->cell_m))
+            {
+                std::cerr << line << ": ";
+                die(" heatmap takes a cell size in meters that is a positive"
+                    " multiple of 50");
+                return false;
+            }
+            this->tree_to_find.clear();
+            getline(iss >> ws, this->tree_to_find);
+            this->tree_to_find.erase(
+                this->tree_to_find.find_last_not_of(" \t\r") + 1);
+            this->type = heatmap_cmmd;
+        }
+        else if(first_word == "diversity")
+        {
+            string by;
+            iss >> by;
+            this->cell_m = 0;
+            if(by == "grid")
+                iss >> this->cell_m;
+            bool valid = by == "zip" ||
+                         (by == "grid" && iss &&
+                          DensityPyramid::valid_cell_size(this->cell_m));
+            if(! valid)
+            {
+                std::cerr << line << ": ";
+                die(" diversity takes zip, or grid and a cell size in meters"
+                    " that is a positive multiple of 50");
+                return false;
+            }
+            this->type = diversity_cmmd;
+        }
+        else if(first_word == "nearest_same_species_stats")
+        {
+            this->tree_to_find.clear();
+            getline(iss >> ws, this->tree_to_find);
+            this->tree_to_find.erase(
+                this->tree_to_find.find_last_not_of(" \t\r") + 1);
+            if(this->tree_to_find.empty())
+            {
+                std::cerr << line << ": ";
+                die(" Missing species for nearest_same_species_stats command");
+                return false;
+            }
+            this->type = nearest_same_species_cmmd;
+        }
         else
             this->type = bad_cmmd;
     }
@@ -158,7 +347,7 @@ void Command::get_args( string &arg_tree_to_find, int &arg_zip,
 {
     
     result = true;
-    if(tree_info_cmmd == type)
+    if(tree_info_cmmd == type || nearest_same_species_cmmd == type)
         arg_tree_to_find = tree_to_find;
     else if(listall_inzip_cmmd == type)
         arg_zip = zip;
@@ -169,4 +358,66 @@ void Command::get_args( string &arg_tree_to_find, int &arg_zip,
         arg_distance = distance;
     }
     else result = false;
-}
\ No newline at end of file
+}
+
+int Command::tree_id() const
+{
+    return id;
+}
+
+void Command::get_page( int &arg_offset, int &arg_limit ) const
+{
+    arg_offset = offset;
+    arg_limit = limit;
+}
+
+Near_mode Command::near_mode() const
+{
+    return mode;
+}
+
+void Command::get_box( double &arg_lat1, double &arg_lon1, double &arg_lat2,
+                       double &arg_lon2 ) const
+{
+    arg_lat1 = latitude;
+    arg_lon1 = longitude;
+    arg_lat2 = latitude2;
+    arg_lon2 = longitude2;
+}
+
+const string &Command::polygon_file() const
+{
+    return path;
+}
+
+const Polygon &Command::polygon() const
+{
+    return *shape;
+}
+
+void Command::get_heatmap( int &arg_cell_m, string &arg_species ) const
+{
+    arg_cell_m = cell_m;
+    arg_species = tree_to_find;
+}
+
+void Command::get_diversity( int &arg_cell_m ) const
+{
+    arg_cell_m = cell_m;
+}
+
+void Command::get_change( string &arg_field, string &arg_value ) const
+{
+    arg_field = field;
+    arg_value = value;
+}
+
+string Command::change_text() const
+{
+    if(add_tree_cmmd == type)
+        return "add_tree " + value;
+    else if(update_tree_cmmd == type)
+        return "update_tree " + to_string(id) + " " + field + " " + value;
+    else
+        return "delete_tree " + to_string(id);
+}
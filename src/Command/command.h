@@ -40,6 +40,8 @@
 
 using namespace std;
 
+class Polygon;
+
 /** Command_type: 
     An enumerated type to represent the different types of commands. This is  
     more efficient than storing command types as strings. Notice that the last
@@ -54,11 +56,33 @@ typedef enum{
     list_near_cmmd,
     print_all_cmmd,
     remove_stumps_cmmd,
+    tree_by_id_cmmd,
+    add_tree_cmmd,
+    update_tree_cmmd,
+    delete_tree_cmmd,
+    memory_report_cmmd,
+    list_in_box_cmmd,
+    list_in_polygon_cmmd,
+    heatmap_cmmd,
+    diversity_cmmd,
+    nearest_same_species_cmmd,
     bad_cmmd,
     null_cmmd,
     num_Command_types
 }Command_type;
 
+/** Near_mode:
+    How a list_near command counts: exact_near measures every tree, the
+    default; approximate_near takes the counts of the grid cells wholly
+    within the distance and measures the trees of the others; estimate_near
+    measures no tree and gives an error bound with each count.
+*/
+typedef enum{
+    exact_near=0,
+    approximate_near,
+    estimate_near
+}Near_mode;
+
 /*******************************************************************************
                               Command Class Interface
 *******************************************************************************/
@@ -107,6 +131,7 @@ class Command{
      * if remove_stumps_cmmd, then nothing
      * if listall_inzip_cmmd, then the zipcode
      * if list_near_cmmd, then the latitude,longitude, and distance,
+     * if nearest_same_species_cmmd, then tree_to_find
      * @pre  Command_type is initialized to a valid value
      * @post Either result == false or all members are
      *       set to the values in the object.
@@ -119,13 +144,83 @@ class Command{
         double &arg_distance,
         bool &result) const;
     
+    /** tree_id() returns the census id argument of a tree_by_id command.
+     * @pre  type_of() == tree_by_id_cmmd
+     * @return the id to look up; undefined for other command types
+     */
+    int tree_id() const;
+    
+    /** get_page(offset,limit) retrieves the optional paging arguments of a
+     * print_all command. A print_all without arguments has offset 0 and a
+     * negative limit, which means no limit.
+     * @pre  type_of() == print_all_cmmd
+     */
+    void get_page(int &arg_offset, int &arg_limit) const;
+    
+    /** near_mode() returns how a list_near command counts: the optional
+     * word "approximate" or "estimate" after its distance.
+     * @pre  type_of() == list_near_cmmd
+     */
+    Near_mode near_mode() const;
+    
+    /** get_box(lat1,lon1,lat2,lon2) retrieves the corners of the box of a
+     * list_in_box command, as they were given.
+     * @pre  type_of() == list_in_box_cmmd
+     */
+    void get_box(double &arg_lat1, double &arg_lon1, double &arg_lat2,
+                 double &arg_lon2) const;
+    
+    /** polygon_file() and polygon() return the file a list_in_polygon
+     * command names and the polygon get_next() read from it.
+     * @pre  type_of() == list_in_polygon_cmmd
+     */
+    const string &polygon_file() const;
+    
+    const Polygon &polygon() const;
+    
+    /** get_heatmap(cell_m,species) retrieves the cell size in meters of a
+     * heatmap command and its species, which is empty for all species.
+     * @pre  type_of() == heatmap_cmmd
+     */
+    void get_heatmap(int &arg_cell_m, string &arg_species) const;
+    
+    /** get_diversity(cell_m) retrieves the cell size in meters of a
+     * "diversity grid" command, or 0 for "diversity zip".
+     * @pre  type_of() == diversity_cmmd
+     */
+    void get_diversity(int &arg_cell_m) const;
+    
+    /** get_change(field,value) retrieves the arguments of a change command:
+     * the data row of add_tree, or the field and its new value for
+     * update_tree. tree_id() has the id of update_tree and delete_tree.
+     * @pre  type_of() is add_tree_cmmd, update_tree_cmmd or delete_tree_cmmd
+     */
+    void get_change(string &arg_field, string &arg_value) const;
+    
+    /** change_text() returns a change command as one line without '\n', in
+     * the form get_next() reads, for the change log
+     * @pre  type_of() is add_tree_cmmd, update_tree_cmmd or delete_tree_cmmd
+     */
+    string change_text() const;
+    
     private:
     Command_type type;       // The type of the Command object
     string tree_to_find;
     int zip{};
+    int id{};
+    int offset{};
+    int limit{-1};
+    int cell_m{};
+    Near_mode mode{exact_near};
     double latitude{};
     double longitude{};
     double distance{};
+    double latitude2{};
+    double longitude2{};
+    string field;
+    string value;
+    string path;
+    shared_ptr<const Polygon> shape;    // shared by the copies of a command
 };
 
 #endif /* __COMMAND_H__ */
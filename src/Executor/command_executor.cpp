@@ -0,0 +1,302 @@
+/**
+    command_executor.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement command_executor class; the command handlers were
+             moved here from main.cpp
+    
+    License: Copyright 2020 Keisuke Suzuki, based on code written by
+        Stewart Weiss, copyrighted under the GPLv3, 2019
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "command_executor.h"
+#include "../ResultWriter/result_writer.h"
+#include "../Stats/run_stats.h"
+#include "../Trace/trace.h"
+
+const string BORO_NAMES[5]={
+    "Bronx", "Manhattan", "Brooklyn", "Queens", "Staten Island"
+};
+
+/****************************Helper Functions**********************************/
+
+bool changes_collection(Command_type type){
+    return type==remove_stumps_cmmd || type==add_tree_cmmd ||
+           type==update_tree_cmmd || type==delete_tree_cmmd;
+}
+
+/****************************CommandExecutor Class*****************************/
+
+CommandExecutor::CommandExecutor(const TreeCollection &_trees): trees(_trees),
+                                 writable(nullptr), log(nullptr), rows(-1),
+                                 complete(true){}
+
+CommandExecutor::CommandExecutor(const TreeCollection &_trees, long _rows,
+                                 bool _complete): trees(_trees),
+                                 writable(nullptr), log(nullptr), rows(_rows),
+                                 complete(_complete){}
+
+CommandExecutor::CommandExecutor(TreeCollection &_trees, ChangeLog *_log,
+                                 long _rows, bool _complete): trees(_trees),
+                                 writable(&_trees), log(_log), rows(_rows),
+                                 complete(_complete){}
+
+void CommandExecutor::execute(const Command &command, __ResultWriter &out){
+    if(command.type_of()==null_cmmd){
+        run(command, out);
+        return;
+    }
+    TRACE_SPAN("command", command_name(command.type_of()));
+    RunStats &stats=RunStats::instance();
+    if(!stats.enabled()){
+        run(command, out);
+        return;
+    }
+    CountingResultWriter counted(out);
+    uint64_t start=now_ns();
+    long scanned;
+    {
+        CounterScope counters(stats.command_counters(command.type_of()));
+        scanned=run(command, counted);
+    }
+    stats.record_command(command.type_of(), now_ns()-start, scanned,
+                         counted.rows());
+}
+
+long CommandExecutor::run(const Command &command, __ResultWriter &out){
+    string treename;
+    int zipcode, offset, limit, cell_m;
+    double latitude, longitude, distance, latitude2, longitude2;
+    bool result;
+    const Tree *found_tree;
+    int changed;
+    long scanned=0;
+    
+    command.get_args(treename, zipcode, latitude, longitude, distance, result);
+    out.begin_command(command);
+    if(rows>=0)
+        out.coverage(rows, complete);
+    switch(command.type_of()){
+        case tree_info_cmmd:tree_info(treename, out);
+            break;
+        
+        case listall_names_cmmd:
+            for(const auto &name:trees.get_all_species())
+                out.species(name);
+            break;
+        
+        case print_all_cmmd:command.get_page(offset, limit);
+            if(limit<0 && trees.total_tree_count()==0){
+                out.no_trees();
+                break;
+            }
+            if(limit<0) limit=trees.total_tree_count();
+            trees.for_each_tree(offset, limit, [&](const Tree &t){
+                out.tree(t);
+                scanned++;
+            });
+            break;
+        
+        case remove_stumps_cmmd:
+            break;
+        
+        case tree_by_id_cmmd:
+            found_tree=trees.tree_by_id(command.tree_id());
+            if(found_tree==nullptr)
+                out.no_such_tree(command.tree_id());
+            else{
+                out.tree(*found_tree);
+                scanned=1;
+            }
+            break;
+        
+        case list_near_cmmd:
+            if(command.near_mode()==exact_near){
+                scanned=trees.total_tree_count();
+                frequencies(trees.find_near(latitude, longitude, distance),
+                            out);
+                break;
+            }
+            near_counts(trees.count_near(latitude, longitude, distance,
+                                         command.near_mode()==estimate_near),
+                        command.near_mode()==estimate_near, out);
+            if(command.near_mode()==approximate_near)
+                scanned=trees.total_tree_count();
+            break;
+        
+        case listall_inzip_cmmd:
+            scanned=trees.total_tree_count();
+            frequencies(trees.find_in_zipcode(zipcode), out);
+            break;
+        
+        case list_in_box_cmmd:
+            command.get_box(latitude, longitude, latitude2, longitude2);
+            scanned=trees.total_tree_count();
+            frequencies(trees.find_in_box(latitude, longitude, latitude2,
+                                          longitude2), out);
+            break;
+        
+        case list_in_polygon_cmmd:
+            scanned=trees.total_tree_count();
+            frequencies(trees.find_in_polygon(command.polygon()), out);
+            break;
+        
+        case heatmap_cmmd:
+            command.get_heatmap(cell_m, treename);
+            if(!treename.empty()){
+                scanned=trees.count_of_tree_species(treename);
+                if(scanned==0){
+                    out.no_matching_species();
+                    break;
+                }
+            }
+            for(const HeatCell &c:trees.heatmap(cell_m, treename))
+                out.cell(c.x, c.y, c.count);
+            break;
+        
+        case diversity_cmmd:
+            command.get_diversity(cell_m);
+            scanned=trees.total_tree_count();
+            for(const Diversity &d:trees.diversity(cell_m))
+                out.diversity(d);
+            break;
+        
+        case nearest_same_species_cmmd:
+            scanned=trees.count_of_tree_species(treename);
+            if(scanned==0){
+                out.no_matching_species();
+                break;
+            }
+            out.nearest(trees.nearest_same_species(treename));
+            break;
+        
+        case add_tree_cmmd:
+        case update_tree_cmmd:
+        case delete_tree_cmmd:
+            if(writable==nullptr){
+                out.flush();
+                cerr<<"trees cannot be changed in this mode"<<endl;
+                break;
+            }
+            changed=log!=nullptr?log->apply(command):
+                    apply_change(*writable, command);
+            if(changed<0){
+                out.flush();
+                cerr<<"could not write the change log"<<endl;
+            }
+            else{
+                out.changed(changed);
+                scanned=changed;
+            }
+            break;
+        
+        case memory_report_cmmd:
+            scanned=trees.total_tree_count();
+            memory_report(out);
+            break;
+        
+        case bad_cmmd:out.flush();
+            cerr<<"bad command"<<endl;
+            break;
+        
+        default:break;
+    }
+    out.end_command();
+    return scanned;
+}
+
+void CommandExecutor::tree_info(const string &treename,
+                                __ResultWriter &out) const{
+    boro tree_counts_by_borough[5]={{0, "Bronx"},
+                                    {0, "Manhattan"},
+                                    {0, "Brooklyn"},
+                                    {0, "Queens"},
+                                    {0, "Staten Island"}};
+    vector<const string *> matching_species=
+        trees.find_matching_species(treename);
+    
+    if(matching_species.empty()){
+        out.no_matching_species();
+        return;
+    }
+    for(const string *matching_specie:matching_species)
+        out.species(*matching_specie);
+    
+    // Get total numbers of all matching species by boro
+    int total=0;
+    for(const string *matching_specie:matching_species)
+        total+=trees.get_counts_of_trees_by_boro(*matching_specie,
+                                                 tree_counts_by_borough);
+    
+    // NYC total first, then by boro
+    int total_in_city=trees.total_tree_count();
+    out.popularity("New York City", total, total_in_city,
+                   total_in_city>0?(double) 100.00*total/total_in_city:0);
+    rep(i, 5){
+        int boro_total=trees.count_of_trees_in_boro(BORO_NAMES[i]);
+        out.popularity(BORO_NAMES[i], tree_counts_by_borough[i].count,
+                       boro_total,
+                       boro_total>0?(double) 100.00*
+                                    tree_counts_by_borough[i].count/boro_total
+                                   :0);
+    }
+}
+
+//writes the counts of count_near(), with their error bounds if they are
+//estimates
+void CommandExecutor::near_counts(const vector<NearCount> &counts,
+                                  bool estimates, __ResultWriter &out) const{
+    for(const NearCount &c:counts)
+        if(estimates)
+            out.estimate(*c.name, c.count, c.error);
+        else
+            out.frequency(*c.name, c.count);
+}
+
+//writes the heap memory of each part of the collection, their total and,
+//to hold the total against, the resident and peak resident memory of the
+//process with the part of it the total does not explain
+void CommandExecutor::memory_report(__ResultWriter &out) const{
+    long count=trees.total_tree_count();
+    double per_tree=count>0?1.0/count:0;
+    long total=0;
+    for(const auto &part:trees.memory_usage()){
+        out.memory(part.structure, part.items, part.bytes,
+                   part.bytes*per_tree);
+        total+=part.bytes;
+    }
+    out.memory("total", count, total, total*per_tree);
+    long rss=proc_status_kb("VmRSS")*1024, peak=proc_status_kb("VmHWM")*1024;
+    if(rss<0 || peak<0)
+        return;
+    out.memory("VmRSS", count, rss, rss*per_tree);
+    out.memory("VmHWM", count, peak, peak*per_tree);
+    out.memory("unaccounted", count, rss-total, (rss-total)*per_tree);
+}
+
+//passes each run of trees of equal names on as one frequency row; runs of
+//the empty name, which trees without a species have, are skipped
+void CommandExecutor::frequencies(const vector<const Tree *> &found,
+                                  __ResultWriter &out) const{
+    auto it=found.begin();
+    while(it!=found.end()){
+        const string &name=(*it)->common_name();
+        auto run_end=it;
+        long freq=0;
+        while(run_end!=found.end() && (*run_end)->common_name()==name){
+            ++run_end;
+            ++freq;
+        }
+        if(!name.empty())
+            out.frequency(name, freq);
+        it=run_end;
+    }
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+Title           : command_executor.h
+Created on      : Oct 19, 2026
+Description     : Interface of the CommandExecutor class
+Purpose         : Runs a Command against a TreeCollection and passes the
+                  results to a __ResultWriter
+*******************************************************************************/
+
+#ifndef SW2_COMMAND_EXECUTOR_H_
+#define SW2_COMMAND_EXECUTOR_H_
+
+#include "../Command/command.h"
+#include "../TreeCollection/tree_collection.h"
+#include "../ResultWriter/__result_writer.h"
+#include "../ChangeLog/change_log.h"
+
+/** class CommandExecutor holds the logic of every command, so that the same
+ *  commands can be run from main() and elsewhere with any output format.
+ */
+class CommandExecutor{
+    public:
+    
+    explicit CommandExecutor(const TreeCollection &trees);
+    
+    /** CommandExecutor(trees,rows,complete) also tags the results of every
+     *  command with the number of data file rows trees covers, and with
+     *  whether that is the whole file
+     */
+    CommandExecutor(const TreeCollection &trees, long rows, bool complete);
+    
+    /** CommandExecutor(trees,log,rows,complete) can also run the change
+     *  commands. They go through log, which writes them down first, unless
+     *  log is nullptr. The other executors report change commands as
+     *  errors. rows and complete are as above; rows < 0 tags nothing.
+     */
+    CommandExecutor(TreeCollection &trees, ChangeLog *log, long rows=-1,
+                    bool complete=true);
+    
+    /** execute(c,out) runs command c and writes its results on out
+     *  @param Command        c   [in]    the command to run
+     *  @param __ResultWriter out [inout] receives the results
+     */
+    void execute(const Command &command, __ResultWriter &out);
+    
+    private:
+    
+    const TreeCollection &trees;
+    TreeCollection *writable;
+    ChangeLog *log;
+    long rows;
+    bool complete;
+    
+    /** run(c,out) is execute() without the stats
+     *  @return long the number of trees c looked at: every tree for the
+     *               scans of list_near, list_in_box, list_in_polygon,
+     *               listall_inzip, diversity and memory_report, the trees
+     *               of its species for a heatmap of one species and
+     *               nearest_same_species_stats, the trees found or changed
+     *               for the others; tree_info, listall_names, a heatmap of
+     *               all species and a list_near estimate use counts kept as
+     *               trees are added and look at none
+     */
+    long run(const Command &command, __ResultWriter &out);
+    
+    void tree_info(const string &treename, __ResultWriter &out) const;
+    
+    void frequencies(const vector<const Tree *> &found,
+                     __ResultWriter &out) const;
+    
+    void near_counts(const vector<NearCount> &counts, bool estimates,
+                     __ResultWriter &out) const;
+    
+    void memory_report(__ResultWriter &out) const;
+};
+
+/** changes_collection(t) returns true if commands of type t may modify the
+ *  collection, so that they cannot run at the same time as other commands
+ */
+bool changes_collection(Command_type type);
+
+#endif //SW2_COMMAND_EXECUTOR_H_
@@ -0,0 +1,97 @@
+/**
+    parallel_runner.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement parallel_runner class
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "parallel_runner.h"
+#include "command_executor.h"
+#include "../ResultWriter/result_writer.h"
+#include "../Scheduler/task_scheduler.h"
+
+/****************************ParallelRunner Class******************************/
+
+ParallelRunner::ParallelRunner(TreeCollection &_trees, Output_format _format,
+                               ChangeLog *_log): trees(_trees),
+                                                 format(_format), log(_log){}
+
+int ParallelRunner::run(istream &commandfile, ostream &out){
+    vector<Command> commands;
+    Command command;
+    int status=0;
+    
+    //same reading loop as the serial one in main()
+    while(!commandfile.eof()){
+        if(!command.get_next(commandfile)){
+            if(!commandfile.eof()){
+                cerr<<"Error getting command.\n";
+                continue;
+            }
+            status=1;
+            break;
+        }
+        commands.push_back(command);
+    }
+    
+    //one output buffer per command, filled by the task that runs it
+    auto run_one=[this](const Command &c, long seq){
+        ostringstream buffer;
+        //change commands are barriers, so they always run alone
+        CommandExecutor executor(trees, log);
+        unique_ptr<__ResultWriter> writer=make_result_writer(format, buffer,
+                                                             seq);
+        executor.execute(c, *writer);
+        writer->flush();
+        return buffer.str();
+    };
+    
+    TaskScheduler &scheduler=TaskScheduler::instance();
+    size_t next=0;
+    while(next<commands.size()){
+        if(changes_collection(commands[next].type_of())){
+            out<<run_one(commands[next], next);
+            next++;
+            continue;
+        }
+        
+        //run everything up to the next barrier, printing in order; while a
+        //result is not ready, this thread runs queued commands itself
+        size_t end=next;
+        while(end<commands.size() &&
+              !changes_collection(commands[end].type_of()))
+            end++;
+        vector<string> results(end-next);
+        unique_ptr<atomic<bool>[]> done(new atomic<bool>[end-next]);
+        TaskGroup group(scheduler);
+        for(size_t i=next; i<end; i++){
+            done[i-next]=false;
+            group.run([&, i]{
+                results[i-next]=run_one(commands[i], i);
+                done[i-next]=true;
+            });
+        }
+        for(size_t i=next; i<end; i++){
+            while(!done[i-next])
+                if(!scheduler.run_one())
+                    this_thread::yield();
+            out<<results[i-next];
+            results[i-next].clear();
+            results[i-next].shrink_to_fit();
+        }
+        group.wait();
+        next=end;
+    }
+    out.flush();
+    return status;
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************
+Title           : parallel_runner.h
+Created on      : Oct 19, 2026
+Description     : Interface of the ParallelRunner class
+Purpose         : Runs the commands of a command file on several threads
+                  while printing exactly what a serial run prints
+*******************************************************************************/
+
+#ifndef SW2_PARALLEL_RUNNER_H_
+#define SW2_PARALLEL_RUNNER_H_
+
+#include "../Command/command.h"
+#include "../TreeCollection/tree_collection.h"
+#include "../ResultWriter/__result_writer.h"
+#include "../ChangeLog/change_log.h"
+
+/** class ParallelRunner reads the whole command file first. Each command
+ *  then runs as its own task on the shared TaskScheduler and writes into
+ *  its own buffer, and the buffers are copied to the output in the order of
+ *  the command file, each as soon as it and all the ones before it are
+ *  done. A command that changes the collection is a barrier: it starts
+ *  after every earlier command has finished, and no later command starts
+ *  before it is done.
+ */
+class ParallelRunner{
+    public:
+    
+    /** ParallelRunner(trees,format,log) writes changes to log, if it is not
+     *  nullptr, before applying them
+     */
+    ParallelRunner(TreeCollection &trees, Output_format format,
+                   ChangeLog *log=nullptr);
+    
+    /** run(commands,out) runs the command file commands and prints on out
+     *  @return int the exit status a serial run would have: 1 if the last
+     *              command line could not be read, 0 otherwise
+     */
+    int run(istream &commands, ostream &out);
+    
+    private:
+    
+    TreeCollection &trees;
+    Output_format format;
+    ChangeLog *log;
+};
+
+#endif //SW2_PARALLEL_RUNNER_H_
@@ -21,6 +21,7 @@
 
 const double R=6372.8;              // radius of earth in km
 const double TO_RAD=M_PI/180.34;    // conversion of degree
+const double BOUND_SLACK=1e-9;      // covers the rounding of the bounds
 
 /****************************Helper Function***********************************/
 
@@ -36,6 +37,32 @@ double haversine(double lat1, double lon1, double lat2, double lon2){
     return 2*R*asin(sqrt(a*a+cos(lat1)*cos(lat2)*b*b));
 }
 
+double great_circle(double lat1, double lon1, double lat2, double lon2){
+    const double DEGREE=M_PI/180;
+    double a=sin((lat2-lat1)*DEGREE/2);
+    double b=sin((lon2-lon1)*DEGREE/2);
+    double h=a*a+cos(lat1*DEGREE)*cos(lat2*DEGREE)*b*b;
+    return 2*R*asin(h>1?1:sqrt(h));     //rounding may take h past 1
+}
+
+//the latitudes differ by at most the angle of the distance; the cosine of
+//the other latitude is smallest at the farthest latitude it can have
+void great_circle_bounds(double lat, double distance, double &lat_span,
+                         double &lon_span){
+    const double DEGREE=M_PI/180;
+    double half_angle=distance/(2*R);
+    lat_span=lon_span=INFINITY;
+    if(!(half_angle<M_PI/2))
+        return;
+    lat_span=2*half_angle/DEGREE*(1+BOUND_SLACK)+BOUND_SLACK;
+    double s=sin(half_angle);
+    double farthest=(fabs(lat)+lat_span)*DEGREE;
+    double cosines=cos(lat*DEGREE)*cos(farthest);
+    if(farthest<M_PI/2 && s*s<cosines)
+        lon_span=2*asin(sqrt(s*s/cosines))/DEGREE*(1+BOUND_SLACK)+
+                 BOUND_SLACK;
+}
+
 /******************************GPS class***************************************/
 
 GPS::GPS(double lon, double lat): longitude(lon), latitude(lat){
@@ -50,6 +77,23 @@ double distance_between(const GPS &point1, const GPS &point2){
                      point2.latitude, point2.longitude);
 }
 
+//haversine() is given the latitudes first, so the second coordinate of a
+//GPS bounds the first sine on its own, and the first coordinate is weighted
+//by the cosines of the second ones
+void distance_bounds(const GPS &center, double distance, double &first,
+                     double &second){
+    double half_angle=distance/(2*R);
+    first=second=INFINITY;
+    if(!(half_angle<M_PI/2))
+        return;
+    second=2*half_angle/TO_RAD*(1+BOUND_SLACK)+BOUND_SLACK;
+    double s=sin(half_angle);
+    double farthest=(fabs(center.latitude)+second)*TO_RAD;
+    double cosines=cos(center.latitude*TO_RAD)*cos(farthest);
+    if(farthest<M_PI/2 && s*s<cosines)
+        first=2*asin(sqrt(s*s/cosines))/TO_RAD*(1+BOUND_SLACK)+BOUND_SLACK;
+}
+
 std::ostream &operator <<(std::ostream &out, const GPS &point){
     return out<<std::fixed<<"POINT("
               <<point.latitude<<" "<<point.longitude<<")"<<std::endl;
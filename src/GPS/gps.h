@@ -22,6 +22,35 @@ struct BadCRS{
     }
 };
 
+/* haversine(lat1,lon1,lat2,lon2) returns the distance in km that
+   distance_between() finds between the two points */
+double haversine(double lat1, double lon1, double lat2, double lon2);
+
+/* great_circle(lat1,lon1,lat2,lon2) returns the great-circle distance in km
+   between two points given as latitude and longitude in degrees. Unlike
+   distance_between(), which list_near and the scans built on it keep using
+   so that their output stays as it always was, it takes the latitudes as
+   latitudes and converts degrees exactly, so its distances are real ones. */
+double great_circle(double lat1, double lon1, double lat2, double lon2);
+
+/* great_circle_bounds(lat,distance,lat_span,lon_span) sets lat_span and
+   lon_span to how many degrees the latitude and the longitude of a point
+   can differ from those of a point at latitude lat if great_circle() finds
+   the two at most distance km apart, rounded up a little; INFINITY if they
+   are not bounded. */
+void great_circle_bounds(double lat, double distance, double &lat_span,
+                         double &lon_span);
+
+class GPS;
+
+/* distance_bounds(center,distance,first,second) sets first and second to how
+   many degrees the first and the second coordinate given to GPS() of a point
+   can differ from those of center if distance_between() finds the point at
+   most distance km from center, rounded up a little; INFINITY if they are
+   not bounded. They hold for points less than 180 degrees from center. */
+void distance_bounds(const GPS &center, double distance, double &first,
+                     double &second);
+
 class GPS{
     public:
     
@@ -31,6 +60,9 @@ class GPS{
     
     friend double distance_between(const GPS &point1, const GPS &point2);
     
+    friend void distance_bounds(const GPS &center, double distance,
+                                double &first, double &second);
+    
     friend std::ostream &operator <<(std::ostream &out, const GPS &point);
     
     //friend GPS reproject_coords(double x, double y);
@@ -0,0 +1,268 @@
+/**
+    census_generator.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement census_generator class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "census_generator.h"
+#include "../Output/buffered_writer.h"
+
+// the columns Tree(str) reads
+const int ID_COLUMN=0;
+const int DBH_COLUMN=1;
+const int STATUS_COLUMN=6;
+const int HEALTH_COLUMN=7;
+const int SPECIES_COLUMN=9;
+const int ADDRESS_COLUMN=24;
+const int ZIPCODE_COLUMN=25;
+const int BORO_COLUMN=29;
+const int LATITUDE_COLUMN=37;
+const int LONGITUDE_COLUMN=38;
+const int NUM_COLUMNS=41;
+
+const size_t RECENT_ROWS=1024;
+const double MEAN_BLOCK_TREES=6;
+const double SAME_SPECIES_ON_BLOCK=0.6;
+const double BLOCK_SPREAD=0.006;     // degrees around the zip code center
+const double TREE_SPREAD=0.0003;     // degrees around the block
+const double STUMP_RATE=0.0258;
+const double DEAD_RATE=0.0204;
+const double GOOD_RATE=0.810;
+const double FAIR_RATE=0.148;
+
+struct Borough{
+    const char *name;
+    long trees;
+    double south, north, west, east;
+    vector<pair<int, int>> zip_ranges;
+};
+
+// tree counts of the 2015 census, rough outlines, and zip codes
+const Borough BOROUGHS[]={
+    {"Bronx", 85203, 40.80, 40.91, -73.93, -73.77, {{10451, 10475}}},
+    {"Manhattan", 65423, 40.70, 40.88, -74.02, -73.91, {{10001, 10040}}},
+    {"Brooklyn", 177293, 40.57, 40.74, -74.04, -73.86, {{11201, 11239}}},
+    {"Queens", 250551, 40.54, 40.80, -73.96, -73.70,
+        {{11101, 11106}, {11354, 11379}, {11411, 11436}, {11691, 11697}}},
+    {"Staten Island", 105318, 40.50, 40.65, -74.26, -74.05,
+        {{10301, 10314}}}
+};
+
+// the most common species, with roughly their 2015 census counts
+const pair<const char *, double> SPECIES[]={
+    {"london planetree", 87014}, {"honeylocust", 64264},
+    {"Callery pear", 58931}, {"pin oak", 53185}, {"Norway maple", 34189},
+    {"littleleaf linden", 29742}, {"cherry", 29279},
+    {"Japanese zelkova", 29258}, {"ginkgo", 21024}, {"Sophora", 19338},
+    {"red maple", 17246}, {"green ash", 16251}, {"American linden", 13530},
+    {"silver maple", 12277}, {"sweetgum", 10657}, {"northern red oak", 8400},
+    {"silver linden", 7995}, {"American elm", 7975},
+    {"swamp white oak", 7975}, {"crab apple", 7974}, {"Chinese elm", 5765},
+    {"sawtooth oak", 5271}, {"hawthorn", 4889}, {"eastern redbud", 4815},
+    {"Amur maple", 4370}, {"black locust", 4097}, {"white oak", 3873},
+    {"willow oak", 3630}, {"tree of heaven", 3445},
+    {"red horse chestnut", 3105}, {"Kentucky coffeetree", 2923},
+    {"Turkish hazelnut", 2839}, {"black cherry", 2750}, {"mulberry", 2511},
+    {"crimson king maple", 2354}, {"Amur cork tree", 2214},
+    {"purple-leaf plum", 2091}, {"golden raintree", 1903},
+    {"hedge maple", 1716}, {"sycamore maple", 1603},
+    {"Japanese tree lilac", 1443}, {"serviceberry", 1271}
+};
+
+const char *STREETS[]={"BROADWAY", "MAIN STREET", "5 AVENUE", "OCEAN PARKWAY",
+    "OCEAN AVENUE", "ROCKAWAY BOULEVARD", "HYLAN BOULEVARD",
+    "GRAND CONCOURSE", "JAMAICA AVENUE", "NORTHERN BOULEVARD",
+    "RICHMOND ROAD", "BEDFORD AVENUE", "AMSTERDAM AVENUE", "34 AVENUE",
+    "86 STREET", "UNION TURNPIKE", "VICTORY BOULEVARD", "EAST 14 STREET",
+    "WEST 72 STREET", "FOREST AVENUE", "KINGS HIGHWAY", "ATLANTIC AVENUE",
+    "PELHAM PARKWAY", "HILLSIDE AVENUE"};
+
+/****************************Helper Functions**********************************/
+
+//appends the fields to line as one data file line, quoting the ones that
+//hold the separator
+void join_fields(const string field[], string &line){
+    for(int i=0; i<NUM_COLUMNS; i++){
+        if(i>0)
+            line+=',';
+        if(field[i].find(',')==string::npos)
+            line+=field[i];
+        else
+            line+='"'+field[i]+'"';
+    }
+}
+
+string fixed_digits(double value, int digits){
+    char text[32];
+    snprintf(text, sizeof text, "%.*f", digits, value);
+    return text;
+}
+
+/****************************CensusGenerator Class*****************************/
+
+CensusGenerator::CensusGenerator(unsigned long seed, double _duplicate_rate,
+                                 double _bad_row_rate, int first_id):
+                                 random(seed),
+                                 duplicate_rate(_duplicate_rate),
+                                 bad_row_rate(_bad_row_rate),
+                                 next_id(first_id), made(0), repeated(0),
+                                 broken(0), block_left(0), recent_next(0){
+    //each zip code gets a center in its borough and a share of the
+    //borough's trees
+    double sum=0;
+    for(size_t b=0; b<size(BOROUGHS); b++){
+        const Borough &boro=BOROUGHS[b];
+        int count=0;
+        for(const auto &range:boro.zip_ranges)
+            count+=range.second-range.first+1;
+        for(const auto &range:boro.zip_ranges)
+            for(int code=range.first; code<=range.second; code++){
+                Zip z;
+                z.code=code;
+                z.boro=b;
+                z.latitude=boro.south+uniform()*(boro.north-boro.south);
+                z.longitude=boro.west+uniform()*(boro.east-boro.west);
+                zips.push_back(z);
+                sum+=boro.trees*(0.5+uniform())/count;
+                zip_weights.push_back(sum);
+            }
+    }
+    sum=0;
+    for(const auto &s:SPECIES)
+        species_weights.push_back(sum+=s.second);
+}
+
+void CensusGenerator::write_rows(ostream &out, long n){
+    BufferedWriter writer(out);
+    for(long i=0; i<n; i++)
+        writer.write(next_row()).put('\n');
+}
+
+string CensusGenerator::next_row(){
+    made++;
+    if(!recent.empty() && uniform()<duplicate_rate){
+        repeated++;
+        return recent[(random()>>11)%recent.size()];
+    }
+
+    bool bad=uniform()<bad_row_rate;
+    string line=make_row(bad);
+    if(bad)
+        broken++;
+    else if(recent.size()<RECENT_ROWS)
+        recent.push_back(line);
+    else{
+        recent[recent_next]=line;
+        recent_next=(recent_next+1)%RECENT_ROWS;
+    }
+    return line;
+}
+
+long CensusGenerator::rows() const{
+    return made;
+}
+
+long CensusGenerator::duplicates() const{
+    return repeated;
+}
+
+long CensusGenerator::bad_rows() const{
+    return broken;
+}
+
+//53 random bits, as a double in [0,1)
+double CensusGenerator::uniform(){
+    return (random()>>11)*(1.0/9007199254740992.0);
+}
+
+//Box-Muller, with one of the pair thrown away to keep no state
+double CensusGenerator::normal(){
+    double u1=1-uniform(), u2=uniform();
+    return sqrt(-2*log(u1))*cos(2*M_PI*u2);
+}
+
+//returns the index i with probability proportional to running_sums[i]
+//minus running_sums[i-1]
+size_t CensusGenerator::pick(const vector<double> &running_sums){
+    double x=uniform()*running_sums.back();
+    return upper_bound(running_sums.begin(), running_sums.end(), x)-
+           running_sums.begin();
+}
+
+void CensusGenerator::new_block(){
+    block_zip=pick(zip_weights);
+    const Zip &z=zips[block_zip];
+    const Borough &boro=BOROUGHS[z.boro];
+    block_latitude=min(max(z.latitude+normal()*BLOCK_SPREAD, boro.south),
+                       boro.north);
+    block_longitude=min(max(z.longitude+normal()*BLOCK_SPREAD, boro.west),
+                        boro.east);
+    block_left=1+(long)(-log(1-uniform())*MEAN_BLOCK_TREES);
+    block_street=(random()>>11)%size(STREETS);
+    block_species=pick(species_weights);
+    house_number=1+(random()>>11)%300;
+}
+
+string CensusGenerator::make_row(bool bad){
+    if(block_left==0)
+        new_block();
+    block_left--;
+    const Zip &z=zips[block_zip];
+
+    string field[NUM_COLUMNS];
+    double u=uniform();
+    int dbh=max(1, min(60, (int)lround(exp(log(10.0)+normal()*0.6))));
+    if(u<STUMP_RATE){
+        field[STATUS_COLUMN]="Stump";
+        dbh=0;
+    }
+    else if(u<STUMP_RATE+DEAD_RATE)
+        field[STATUS_COLUMN]="Dead";
+    else{
+        field[STATUS_COLUMN]="Alive";
+        size_t s=uniform()<SAME_SPECIES_ON_BLOCK?block_species:
+                                                 pick(species_weights);
+        field[SPECIES_COLUMN]=SPECIES[s].first;
+        u=uniform();
+        field[HEALTH_COLUMN]=u<GOOD_RATE?"Good":
+                             u<GOOD_RATE+FAIR_RATE?"Fair":"Poor";
+    }
+    field[ID_COLUMN]=to_string(next_id++);
+    field[DBH_COLUMN]=to_string(dbh);
+    field[ADDRESS_COLUMN]=to_string(house_number)+" "+STREETS[block_street];
+    house_number+=2+(random()>>11)%8;
+    field[ZIPCODE_COLUMN]=to_string(z.code);
+    field[BORO_COLUMN]=BOROUGHS[z.boro].name;
+    field[LATITUDE_COLUMN]=fixed_digits(block_latitude+
+                                        normal()*TREE_SPREAD, 8);
+    field[LONGITUDE_COLUMN]=fixed_digits(block_longitude+
+                                         normal()*TREE_SPREAD, 8);
+
+    //break one field in one of the ways Tree(str) checks for
+    if(bad)
+        switch((random()>>11)%4){
+            case 0:field[ID_COLUMN]="T"+field[ID_COLUMN];
+                break;
+            case 1:field[BORO_COLUMN]="New Jersey";
+                break;
+            case 2:field[LATITUDE_COLUMN]="n/a";
+                break;
+            default:field[HEALTH_COLUMN]="Excellent";
+                break;
+        }
+
+    string line;
+    join_fields(field, line);
+    return line;
+}
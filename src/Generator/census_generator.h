@@ -0,0 +1,87 @@
+/*******************************************************************************
+Title           : census_generator.h
+Created on      : Oct 19, 2026
+Description     : Interface of the CensusGenerator class
+Purpose         : Makes up data files of any size that look like the tree
+                  census, so that loading and the commands can be tested at
+                  sizes the real file does not reach
+*******************************************************************************/
+
+#ifndef SW2_CENSUS_GENERATOR_H_
+#define SW2_CENSUS_GENERATOR_H_
+
+using namespace std;
+
+/** class CensusGenerator writes data file lines with the 41 columns
+ *  Tree(str) reads. Boroughs, species, status and health follow roughly the
+ *  proportions of the 2015 census. Each zip code has a center inside its
+ *  borough, and trees come in runs along one block of one street, close
+ *  together and mostly of one species, as street plantings are.
+ *
+ *  A part of the lines can repeat a recent line (duplicate_rate) or be
+ *  broken in a way Tree(str) rejects (bad_row_rate). The same seed and
+ *  rates give the same lines on every platform: the generator only uses the
+ *  raw output of mt19937_64, which the standard fixes, and its own
+ *  distributions on top of it.
+ */
+class CensusGenerator{
+    public:
+
+    /** number of lines in the 2015 census file */
+    static const long CENSUS_ROWS=683788;
+
+    /** CensusGenerator(seed,duplicate_rate,bad_row_rate,first_id) numbers
+     *  the trees from first_id on
+     */
+    explicit CensusGenerator(unsigned long seed=1, double duplicate_rate=0,
+                             double bad_row_rate=0, int first_id=1);
+
+    /** write_rows(out,n) writes the next n lines on out, each ending in '\n'
+     */
+    void write_rows(ostream &out, long n);
+
+    /** next_row() returns the next line, without the '\n' */
+    string next_row();
+
+    /** rows() returns how many lines were made so far */
+    long rows() const;
+
+    /** duplicates() returns how many of them repeat an earlier line */
+    long duplicates() const;
+
+    /** bad_rows() returns how many of them Tree(str) rejects */
+    long bad_rows() const;
+
+    private:
+
+    struct Zip{
+        int code;
+        int boro;
+        double latitude, longitude;
+    };
+
+    mt19937_64 random;
+    double duplicate_rate, bad_row_rate;
+    int next_id;
+    long made, repeated, broken;
+
+    vector<Zip> zips;
+    vector<double> zip_weights;     // running sums, for pick()
+    vector<double> species_weights;
+
+    // the block the trees are planted along
+    long block_left;
+    int block_zip, block_street, block_species, house_number;
+    double block_latitude, block_longitude;
+
+    vector<string> recent;          // the last lines, for duplicates
+    size_t recent_next;
+
+    double uniform();
+    double normal();
+    size_t pick(const vector<double> &running_sums);
+    void new_block();
+    string make_row(bool bad);
+};
+
+#endif //SW2_CENSUS_GENERATOR_H_
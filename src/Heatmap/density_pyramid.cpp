@@ -0,0 +1,126 @@
+/**
+    density_pyramid.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement density_pyramid class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "density_pyramid.h"
+#include "../Memory/memory_usage.h"
+
+/****************************DensityPyramid Class******************************/
+
+DensityPyramid::DensityPyramid(){
+    size_t start=0;
+    for(int level=0; level<LEVELS; level++){
+        level_start[level]=start;
+        start+=(size_t)(BASE_SIDE>>level)*(BASE_SIDE>>level);
+    }
+    counts.assign(start, 0);
+}
+
+bool DensityPyramid::valid_cell_size(int cell_m){
+    return cell_m>0 && cell_m%BASE_CELL_M==0;
+}
+
+bool DensityPyramid::base_cell(double lat, double lon, int &x, int &y){
+    double column=(lon-HEATMAP_WEST)*METERS_PER_DEGREE_LONGITUDE/BASE_CELL_M;
+    double row=(lat-HEATMAP_SOUTH)*METERS_PER_DEGREE_LATITUDE/BASE_CELL_M;
+    if(!(column>=0 && column<BASE_SIDE && row>=0 && row<BASE_SIDE))
+        return false;
+    x=(int)column;
+    y=(int)row;
+    return true;
+}
+
+void DensityPyramid::add(double lat, double lon){
+    change(lat, lon, 1);
+}
+
+void DensityPyramid::remove(double lat, double lon){
+    change(lat, lon, -1);
+}
+
+vector<HeatCell> DensityPyramid::cells(int cell_m) const{
+    //the coarsest level whose cells fit scale times, scale of them to a cell
+    int scale=cell_m/BASE_CELL_M, level=0;
+    while(level<LEVELS-1 && scale%2==0){
+        scale/=2;
+        level++;
+    }
+    int level_side=BASE_SIDE>>level;
+    vector<HeatCell> result;
+    if(scale==1){
+        for(int y=0; y<level_side; y++)
+            for(int x=0; x<level_side; x++)
+                if(counts[cell(level, x, y)]>0)
+                    result.push_back({x, y, (long)counts[cell(level, x, y)]});
+        return result;
+    }
+    int side=(level_side+scale-1)/scale;
+    vector<long> sums((size_t)side*side, 0);
+    for(int y=0; y<level_side; y++)
+        for(int x=0; x<level_side; x++)
+            sums[(size_t)(y/scale)*side+x/scale]+=counts[cell(level, x, y)];
+    for(int y=0; y<side; y++)
+        for(int x=0; x<side; x++)
+            if(sums[(size_t)y*side+x]>0)
+                result.push_back({x, y, sums[(size_t)y*side+x]});
+    return result;
+}
+
+size_t DensityPyramid::size() const{
+    return counts.size();
+}
+
+size_t DensityPyramid::heap_bytes() const{
+    return heap_block(counts.capacity()*sizeof(uint32_t));
+}
+
+size_t DensityPyramid::cell(int level, int x, int y) const{
+    return level_start[level]+(size_t)y*(BASE_SIDE>>level)+x;
+}
+
+void DensityPyramid::change(double lat, double lon, int delta){
+    int x, y;
+    if(!base_cell(lat, lon, x, y))
+        return;
+    for(int level=0; level<LEVELS; level++)
+        counts[cell(level, x>>level, y>>level)]+=delta;
+}
+
+/****************************HeatLayer Class***********************************/
+
+HeatLayer::HeatLayer(int cell_m): scale(cell_m/DensityPyramid::BASE_CELL_M),
+    side((DensityPyramid::BASE_SIDE+scale-1)/scale){}
+
+void HeatLayer::add(double lat, double lon){
+    int x, y;
+    if(DensityPyramid::base_cell(lat, lon, x, y))
+        found.push_back((uint32_t)(y/scale)*side+x/scale);
+}
+
+vector<HeatCell> HeatLayer::cells() const{
+    vector<uint32_t> sorted(found);
+    sort(sorted.begin(), sorted.end());
+    vector<HeatCell> result;
+    for(size_t i=0; i<sorted.size(); ){
+        size_t j=i;
+        while(j<sorted.size() && sorted[j]==sorted[i])
+            j++;
+        result.push_back({(int)(sorted[i]%side), (int)(sorted[i]/side),
+                          (long)(j-i)});
+        i=j;
+    }
+    return result;
+}
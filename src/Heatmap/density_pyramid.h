@@ -0,0 +1,119 @@
+/*******************************************************************************
+Title           : density_pyramid.h
+Created on      : Oct 19, 2026
+Description     : Interface of the DensityPyramid and HeatLayer classes
+Purpose         : Keeps the number of trees in every cell of a grid over the
+                  city, and in the cells of each coarser grid, so that a
+                  heatmap at any cell size is added up from counts instead of
+                  from the trees
+*******************************************************************************/
+
+#ifndef SW2_DENSITY_PYRAMID_H_
+#define SW2_DENSITY_PYRAMID_H_
+
+using namespace std;
+
+/** The grid starts at its south west corner and has square cells of a whole
+ *  number of BASE_CELL_M meters, measured as if a degree of longitude were
+ *  as long everywhere as it is at 40.7 N. 1024 cells of 50 m reach from
+ *  Tottenville to the north of the Bronx and from Staten Island to the east
+ *  of Queens.
+ */
+const double HEATMAP_SOUTH=40.47;
+const double HEATMAP_WEST=-74.27;
+const double METERS_PER_DEGREE_LATITUDE=111320;
+const double METERS_PER_DEGREE_LONGITUDE=84390;
+
+/** HeatCell is the cell in column x, counted to the east, and row y,
+ *  counted to the north, with the number of trees in it
+ */
+struct HeatCell{
+    int x, y;
+    long count;
+};
+
+/** class DensityPyramid counts the trees in each cell of BASE_CELL_M meters,
+ *  and in levels of cells 2, 4, ... 1024 times as wide, each cell holding
+ *  the counts of four of the level below. A heatmap of cells k times as
+ *  wide is added up from the coarsest level whose cells fit k a whole
+ *  number of times, so zooming out reads fewer counts, not more.
+ *  Trees outside the grid are not counted.
+ */
+class DensityPyramid{
+    public:
+
+    static const int BASE_CELL_M=50;
+    static const int LEVELS=11;
+    static const int BASE_SIDE=1<<(LEVELS-1);   // cells on a side
+
+    DensityPyramid();
+
+    /** valid_cell_size(cell_m) is true if cell_m is a positive multiple of
+     *  BASE_CELL_M
+     */
+    static bool valid_cell_size(int cell_m);
+
+    /** base_cell(lat,lon,x,y) sets x and y to the column and row of the
+     *  cell of BASE_CELL_M meters (lat,lon) is in
+     *  @return bool false if (lat,lon) is outside the grid
+     */
+    static bool base_cell(double lat, double lon, int &x, int &y);
+
+    /** add(lat,lon) and remove(lat,lon) count a tree at (lat,lon) in or out
+     *  of the cell it is in at every level
+     */
+    void add(double lat, double lon);
+
+    void remove(double lat, double lon);
+
+    /** cells(cell_m) returns the cells of cell_m meters that hold trees,
+     *  row by row from the south west corner
+     *  @pre valid_cell_size(cell_m)
+     */
+    vector<HeatCell> cells(int cell_m) const;
+
+    /** size() returns the number of counts of all the levels */
+    size_t size() const;
+
+    size_t heap_bytes() const;
+
+    private:
+
+    vector<uint32_t> counts;    // the levels one after the other, finest first
+    size_t level_start[LEVELS]; // where the cells of each level start
+
+    /** cell(level,x,y) returns the index in counts of the cell in column x
+     *  and row y of level, whose cells are 2^level base cells wide
+     */
+    size_t cell(int level, int x, int y) const;
+
+    void change(double lat, double lon, int delta);
+};
+
+/** class HeatLayer counts the trees it is given in cells of cell_m meters of
+ *  the grid of DensityPyramid, for the layers, such as one species, that
+ *  have no pyramid. It keeps the cell of each tree, not a count per cell.
+ */
+class HeatLayer{
+    public:
+
+    /** HeatLayer(cell_m) starts an empty layer
+     *  @pre DensityPyramid::valid_cell_size(cell_m)
+     */
+    explicit HeatLayer(int cell_m);
+
+    void add(double lat, double lon);
+
+    /** cells() returns the cells that hold trees in the order of
+     *  DensityPyramid::cells()
+     */
+    vector<HeatCell> cells() const;
+
+    private:
+
+    int scale;      // base cells on a side of a cell
+    int side;       // cells on a side of the grid
+    vector<uint32_t> found;     // y*side+x of the cell of each tree
+};
+
+#endif //SW2_DENSITY_PYRAMID_H_
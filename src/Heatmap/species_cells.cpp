@@ -0,0 +1,192 @@
+/**
+    species_cells.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement species_cells class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "species_cells.h"
+
+const double CELL_M=DensityPyramid::BASE_CELL_M*SpeciesCells::SCALE;
+const double CELL_SLACK=1e-9;       // degrees around a cell and a share of
+                                    // the distance, against rounding
+
+/****************************Helper Functions**********************************/
+
+//the row or column of the cell at degrees, as a double so that positions
+//far outside the grid do not overflow
+double cell_line(double degrees, double origin, double meters_per_degree){
+    return floor((degrees-origin)*meters_per_degree/CELL_M);
+}
+
+//the distance between two positions, the way list_near measures it
+double near_distance(double lat1, double lon1, double lat2, double lon2){
+    return distance_between(GPS(lat1, lon1), GPS(lat2, lon2));
+}
+
+/****************************SpeciesCells Class********************************/
+
+SpeciesCells::SpeciesCells(): counts(PackedCount{0, 0}){}
+
+SpeciesCells::SpeciesCells(AvlTree<PackedCount, PackedKeyOf> &&shared):
+    counts(move(shared)){}
+
+uint32_t SpeciesCells::cell_of(double lat, double lon){
+    int x, y;
+    if(!DensityPyramid::base_cell(lat, lon, x, y))
+        return OUTSIDE;
+    return (uint32_t)(y/SCALE)*SIDE+x/SCALE;
+}
+
+void SpeciesCells::get_bounds(int x, int y, double &lat_lo, double &lat_hi,
+                              double &lon_lo, double &lon_hi){
+    lat_lo=HEATMAP_SOUTH+y*CELL_M/METERS_PER_DEGREE_LATITUDE-CELL_SLACK;
+    lat_hi=HEATMAP_SOUTH+(y+1)*CELL_M/METERS_PER_DEGREE_LATITUDE+CELL_SLACK;
+    lon_lo=HEATMAP_WEST+x*CELL_M/METERS_PER_DEGREE_LONGITUDE-CELL_SLACK;
+    lon_hi=HEATMAP_WEST+(x+1)*CELL_M/METERS_PER_DEGREE_LONGITUDE+CELL_SLACK;
+}
+
+void SpeciesCells::add(double lat, double lon, uint32_t species){
+    PackedCount key{pack(cell_of(lat, lon), species), 1};
+    if(!counts.modify(key, [](PackedCount &c){ c.count++; }))
+        counts.insert(key);
+}
+
+void SpeciesCells::remove(double lat, double lon, uint32_t species){
+    PackedCount key{pack(cell_of(lat, lon), species), 0};
+    bool empty=false;
+    counts.modify(key, [&empty](PackedCount &c){ empty=--c.count==0; });
+    if(empty)
+        counts.remove(key);
+}
+
+SpeciesCells SpeciesCells::share() const{
+    return SpeciesCells(counts.share());
+}
+
+size_t SpeciesCells::size() const{
+    return counts.size();
+}
+
+size_t SpeciesCells::heap_bytes() const{
+    return counts.nodeBytes();
+}
+
+/****************************NearCells Class***********************************/
+
+NearCells::NearCells(double lat, double lon, double distance, bool sample){
+    double lat_span, lon_span;
+    distance_bounds(GPS(lat, lon), distance, lat_span, lon_span);
+    double first_row=cell_line(lat-lat_span, HEATMAP_SOUTH,
+                               METERS_PER_DEGREE_LATITUDE);
+    double last_row=cell_line(lat+lat_span, HEATMAP_SOUTH,
+                              METERS_PER_DEGREE_LATITUDE);
+    double first_column=cell_line(lon-lon_span, HEATMAP_WEST,
+                                  METERS_PER_DEGREE_LONGITUDE);
+    double last_column=cell_line(lon+lon_span, HEATMAP_WEST,
+                                 METERS_PER_DEGREE_LONGITUDE);
+    const int SIDE=SpeciesCells::SIDE;
+    outside=!(first_row>=0 && last_row<SIDE && first_column>=0 &&
+              last_column<SIDE);
+    y0=(int)min(max(first_row, 0.0), (double)SIDE);
+    y1=(int)max(min(last_row, SIDE-1.0), -1.0);
+    x0=(int)min(max(first_column, 0.0), (double)SIDE);
+    x1=(int)max(min(last_column, SIDE-1.0), -1.0);
+    if(x0>x1 || y0>y1)
+        return;
+
+    kinds.assign((size_t)(y1-y0+1)*(x1-x0+1), APART);
+    parts.assign(kinds.size(), 0);
+    size_t i=0;
+    for(int y=y0; y<=y1; y++)
+        for(int x=x0; x<=x1; x++, i++){
+            double lat_lo, lat_hi, lon_lo, lon_hi;
+            SpeciesCells::get_bounds(x, y, lat_lo, lat_hi, lon_lo, lon_hi);
+            double corners[4][2]={{lat_lo, lon_lo}, {lat_lo, lon_hi},
+                                  {lat_hi, lon_lo}, {lat_hi, lon_hi}};
+            //the distances from a point to the positions of a cell are
+            //largest at a corner, so the corners tell if the cell is whole;
+            //the cell is apart if it is too far from a corner to reach the
+            //point from any of its positions
+            double to_corner[4], farthest=0, nearest=0;
+            for(int c=0; c<4; c++){
+                to_corner[c]=near_distance(lat, lon, corners[c][0],
+                                           corners[c][1]);
+                farthest=max(farthest, to_corner[c]);
+            }
+            if(farthest<=distance*(1-CELL_SLACK)){
+                kinds[i]=WHOLE;
+                parts[i]=1;
+                continue;
+            }
+            for(int c=0; c<4; c++){
+                double across=0;
+                for(const auto &other:corners)
+                    across=max(across, near_distance(corners[c][0],
+                                                     corners[c][1], other[0],
+                                                     other[1]));
+                nearest=max(nearest, to_corner[c]-across);
+            }
+            if(nearest>distance*(1+CELL_SLACK))
+                continue;
+            kinds[i]=EDGE;
+            if(!sample){
+                parts[i]=0.5;
+                continue;
+            }
+            int within=0;
+            for(int a=0; a<SAMPLES; a++)
+                for(int b=0; b<SAMPLES; b++)
+                    if(near_distance(lat, lon,
+                                     lat_lo+(a+0.5)/SAMPLES*(lat_hi-lat_lo),
+                                     lon_lo+(b+0.5)/SAMPLES*(lon_hi-lon_lo))
+                       <=distance)
+                        within++;
+            parts[i]=(float)within/(SAMPLES*SAMPLES);
+        }
+}
+
+void NearCells::get_cells(int &_x0, int &_x1, int &_y0, int &_y1) const{
+    _x0=x0;
+    _x1=x1;
+    _y0=y0;
+    _y1=y1;
+}
+
+bool NearCells::leaves_grid() const{
+    return outside;
+}
+
+bool NearCells::whole(uint32_t cell) const{
+    long i=at(cell);
+    return i>=0 && kinds[i]==WHOLE;
+}
+
+bool NearCells::apart(uint32_t cell) const{
+    long i=at(cell);
+    return i<0 || kinds[i]==APART;
+}
+
+double NearCells::part(uint32_t cell) const{
+    long i=at(cell);
+    return i<0?0:parts[i];
+}
+
+long NearCells::at(uint32_t cell) const{
+    if(cell>=SpeciesCells::OUTSIDE)
+        return -1;
+    int x=cell%SpeciesCells::SIDE, y=cell/SpeciesCells::SIDE;
+    if(x<x0 || x>x1 || y<y0 || y>y1)
+        return -1;
+    return (long)(y-y0)*(x1-x0+1)+(x-x0);
+}
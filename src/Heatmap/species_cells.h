@@ -0,0 +1,142 @@
+/*******************************************************************************
+Title           : species_cells.h
+Created on      : Oct 19, 2026
+Description     : Interface of the SpeciesCells and NearCells classes
+Purpose         : Keeps how many trees of each species are in each cell of a
+                  grid over the city, so that a list_near over a large
+                  radius can count the cells it covers whole instead of
+                  their trees
+*******************************************************************************/
+
+#ifndef SW2_SPECIES_CELLS_H_
+#define SW2_SPECIES_CELLS_H_
+
+#include "density_pyramid.h"
+#include "../AVLTree/AvlTree.h"
+#include "../AVLTree/packed_key.h"
+#include "../GPS/gps.h"
+
+using namespace std;
+
+/** class SpeciesCells counts the trees of each species, numbered as in
+ *  HotTrees, in the cells of SCALE by SCALE cells of the DensityPyramid
+ *  grid, 200 m on a side. Trees outside the grid are counted in one more
+ *  cell, OUTSIDE. The counts are kept in an AvlTree under the cell and the
+ *  species packed into one key, so that the counts of a run of cells of a
+ *  row are one run of the tree, and copies share the nodes of the tree.
+ */
+class SpeciesCells{
+    public:
+
+    static const int SCALE=4;
+    static const int SIDE=DensityPyramid::BASE_SIDE/SCALE;  // cells on a side
+    static const uint32_t OUTSIDE=SIDE*SIDE;
+
+    SpeciesCells();
+
+    /** cell_of(lat,lon) returns y*SIDE+x for the cell in column x and row y
+     *  (lat,lon) is in, or OUTSIDE
+     */
+    static uint32_t cell_of(double lat, double lon);
+
+    /** get_bounds(x,y,lat_lo,lat_hi,lon_lo,lon_hi) sets its arguments to a
+     *  box of degrees that holds every position cell_of() puts in the cell
+     *  in column x and row y
+     */
+    static void get_bounds(int x, int y, double &lat_lo, double &lat_hi,
+                           double &lon_lo, double &lon_hi);
+
+    /** add(lat,lon,s) and remove(lat,lon,s) count a tree of species number
+     *  s at (lat,lon) in or out of its cell
+     */
+    void add(double lat, double lon, uint32_t species);
+
+    void remove(double lat, double lon, uint32_t species);
+
+    /** share() returns a copy that shares the nodes of the counts; see
+     *  AvlTree::share()
+     */
+    SpeciesCells share() const;
+
+    /** for_each_count(first,last,f) calls f(cell,species,count) for the
+     *  species of the cells first to last, in the order of the cells
+     */
+    template <class Visitor>
+        void for_each_count(uint32_t first, uint32_t last, Visitor f) const{
+            int from=counts.rank({pack(first, 0), 0});
+            int to=counts.rank({pack(last+1, 0), 0});
+            counts.forEach(from, to-from, [&f](const PackedCount &c){
+                f((uint32_t)(c.key>>32), (uint32_t)c.key, (long)c.count);
+            });
+        }
+
+    /** size() returns the number of counts: pairs of a cell and a species
+     *  with trees in it
+     */
+    size_t size() const;
+
+    size_t heap_bytes() const;
+
+    private:
+
+    AvlTree<PackedCount, PackedKeyOf> counts;
+
+    explicit SpeciesCells(AvlTree<PackedCount, PackedKeyOf> &&shared);
+
+    static uint64_t pack(uint32_t cell, uint32_t species){
+        return (uint64_t)cell<<32|species;
+    }
+};
+
+/** class NearCells tells how the cells of SpeciesCells in the box around a
+ *  point meet the trees that distance_between() finds within distance of
+ *  it. A cell is whole if every position in it is within distance, and
+ *  apart if none is. Of the others, the edge cells, part() is the share of
+ *  a SAMPLES by SAMPLES grid of points in the cell that are within
+ *  distance; it is 1 for whole cells and 0 for those apart.
+ */
+class NearCells{
+    public:
+
+    static const int SAMPLES=4;
+
+    /** NearCells(lat,lon,distance,sample) sorts the cells of the box of
+     *  positions within distance of (lat,lon). part() is only sampled if
+     *  sample is true; it is 0.5 for the edge cells otherwise.
+     */
+    NearCells(double lat, double lon, double distance, bool sample);
+
+    /** get_cells(x0,x1,y0,y1) sets its arguments to the columns and rows
+     *  of the cells of the box, which is empty if x0>x1 or y0>y1
+     */
+    void get_cells(int &x0, int &x1, int &y0, int &y1) const;
+
+    /** leaves_grid() is true if positions outside the grid may be within
+     *  distance
+     */
+    bool leaves_grid() const;
+
+    /** whole(cell) is true if cell, a cell_of() value, is a whole cell */
+    bool whole(uint32_t cell) const;
+
+    /** apart(cell) is true if cell is apart, or outside the box */
+    bool apart(uint32_t cell) const;
+
+    double part(uint32_t cell) const;
+
+    private:
+
+    enum Kind: char{APART, EDGE, WHOLE};
+
+    int x0, x1, y0, y1;
+    bool outside;
+    vector<Kind> kinds;     // of the cells of the box, row by row
+    vector<float> parts;    // of the cells of the box, row by row
+
+    /** at(cell) returns the index of cell in kinds, or -1 if it is not in
+     *  the box
+     */
+    long at(uint32_t cell) const;
+};
+
+#endif //SW2_SPECIES_CELLS_H_
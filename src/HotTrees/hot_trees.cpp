@@ -0,0 +1,285 @@
+/**
+    hot_trees.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement hot_trees class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "hot_trees.h"
+#include "../Trace/trace.h"
+
+const char *STATUS_NAMES[4]={"", "Alive", "Dead", "Stump"};
+const char *HEALTH_NAMES[4]={"", "Good", "Fair", "Poor"};
+
+const char *BOROUGH_NAMES[5]={"Bronx", "Manhattan", "Brooklyn", "Queens",
+                              "Staten Island"};
+
+/****************************Helper Functions**********************************/
+
+bool encode_coordinate(double degrees, int64_t origin, int32_t &units){
+    double scaled=round(degrees*COORDINATE_UNITS)-origin;
+    if(!(fabs(scaled)<=INT32_MAX)){
+        units=0;
+        return false;
+    }
+    units=(int32_t)scaled;
+    return decode_coordinate(units, origin)==degrees;
+}
+
+//the unit of origin at or past degrees, rounded down or up, cut to int32_t
+int32_t box_end(double degrees, int64_t origin, bool up){
+    double scaled=degrees*COORDINATE_UNITS;
+    scaled=(up?ceil(scaled):floor(scaled))-origin;
+    if(!(scaled>INT32_MIN))
+        return INT32_MIN;
+    if(!(scaled<INT32_MAX))
+        return INT32_MAX;
+    return (int32_t)scaled;
+}
+
+PositionBox position_range(double lat_lo, double lat_hi, double lon_lo,
+                           double lon_hi){
+    return {box_end(lat_lo, LATITUDE_ORIGIN, false),
+            box_end(lat_hi, LATITUDE_ORIGIN, true),
+            box_end(lon_lo, LONGITUDE_ORIGIN, false),
+            box_end(lon_hi, LONGITUDE_ORIGIN, true)};
+}
+
+PositionBox position_box(double lat, double lon, double lat_span,
+                         double lon_span){
+    const double FARTHEST=90*COORDINATE_UNITS;
+    if(!(fabs(lat*COORDINATE_UNITS-LATITUDE_ORIGIN)<=FARTHEST &&
+         fabs(lon*COORDINATE_UNITS-LONGITUDE_ORIGIN)<=FARTHEST))
+        return {INT32_MIN, INT32_MAX, INT32_MIN, INT32_MAX};
+    return position_range(lat-lat_span, lat+lat_span, lon-lon_span,
+                          lon+lon_span);
+}
+
+uint32_t hilbert_key(uint32_t x, uint32_t y){
+    uint32_t key=0;
+    for(uint32_t s=1u<<(HILBERT_BITS-1); s>0; s>>=1){
+        uint32_t rx=(x&s)!=0, ry=(y&s)!=0;
+        key+=s*s*((3*rx)^ry);
+        //turn the quadrant so that the curve inside it starts at its corner;
+        //only the bits below s are read from now on
+        if(ry==0){
+            if(rx==1){
+                x=~x;
+                y=~y;
+            }
+            swap(x, y);
+        }
+    }
+    return key;
+}
+
+//adds the key ranges of the cells of the square at column x and row y,
+//2^level cells on a side, that may be in the cells [x0,x1] by [y0,y1].
+//Squares of 2^min_level cells are not split, so a few cells outside the
+//box keep the number of ranges small.
+void cover_box(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1,
+               uint32_t x, uint32_t y, int level, int min_level,
+               vector<pair<uint64_t, uint64_t>> &ranges){
+    uint64_t side=1ull<<level;
+    if(x>x1 || x+side-1<x0 || y>y1 || y+side-1<y0)
+        return;
+    if(level<=min_level || (x>=x0 && x+side-1<=x1 && y>=y0 &&
+                            y+side-1<=y1)){
+        uint64_t cells=side*side;
+        uint64_t first=hilbert_key(x, y)&~(cells-1);
+        ranges.push_back({first, first+cells-1});
+        return;
+    }
+    uint32_t half=side/2;
+    for(uint32_t dx:{0u, half})
+        for(uint32_t dy:{0u, half})
+            cover_box(x0, x1, y0, y1, x+dx, y+dy, level-1, min_level,
+                      ranges);
+}
+
+//returns the index of name in names, or 15 for a name that is not there
+int code_of(const string &name, const char *const *names, int n){
+    for(int i=0; i<n; i++)
+        if(name==names[i])
+            return i;
+    return 15;
+}
+
+/****************************HotTrees Class************************************/
+
+HotTrees::HotTrees(): by_position(false), added(0), removed(0){}
+
+uint32_t HotTrees::add(const Tree &t){
+    rows.push_back(encode(t));
+    added++;
+    return rows.size()-1;
+}
+
+uint32_t HotTrees::remove(uint32_t row){
+    if(row<keys.size()){
+        rows[row].codes|=HotTree::REMOVED<<12;
+        removed++;
+        return row;
+    }
+    uint32_t last=rows.size()-1;
+    rows[row]=rows[last];
+    rows.pop_back();
+    return last;
+}
+
+void HotTrees::update(uint32_t row, const Tree &t){
+    rows[row]=encode(t);
+}
+
+const HotTree &HotTrees::operator [](uint32_t row) const{
+    return rows[row];
+}
+
+size_t HotTrees::size() const{
+    return rows.size()-removed;
+}
+
+vector<uint32_t> HotTrees::order_by_position(){
+    TRACE_SPAN("index", "order hot records");
+    //the rows without an exact position go last, in the order they were
+    const uint64_t LAST=1ull<<32;
+    vector<pair<uint64_t, uint32_t>> order;
+    order.reserve(size());
+    for(uint32_t r=0; r<rows.size(); r++)
+        if(!rows[r].removed())
+            order.push_back({rows[r].exact_position()?position_key(rows[r])
+                                                      :LAST, r});
+    sort(order.begin(), order.end());
+    vector<uint32_t> new_rows(rows.size(), uint32_t(NO_ROW));
+    vector<HotTree> ordered;
+    ordered.reserve(order.size());
+    keys.clear();
+    for(const auto &o:order){
+        new_rows[o.second]=ordered.size();
+        ordered.push_back(rows[o.second]);
+        if(o.first!=LAST)
+            keys.push_back(o.first);
+    }
+    rows.swap(ordered);
+    by_position=true;
+    added=removed=0;
+    return new_rows;
+}
+
+bool HotTrees::ordered_by_position() const{
+    return by_position;
+}
+
+bool HotTrees::needs_reorder() const{
+    size_t most=max(size_t(REORDER_MIN), keys.size()/8);
+    return by_position && (added>most || removed>most);
+}
+
+HotTrees::Spans HotTrees::box_spans(const PositionBox &box) const{
+    vector<pair<uint64_t, uint64_t>> ranges;
+    if(!keys.empty() && box.lat_lo<=box.lat_hi && box.lon_lo<=box.lon_hi){
+        uint32_t x0=hilbert_cell(box.lon_lo), x1=hilbert_cell(box.lon_hi);
+        uint32_t y0=hilbert_cell(box.lat_lo), y1=hilbert_cell(box.lat_hi);
+        //squares at least a quarter of the box on a side
+        int min_level=0;
+        while((1ull<<(min_level+2))<=max(x1-x0, y1-y0)+1ull)
+            min_level++;
+        cover_box(x0, x1, y0, y1, 0, 0, HILBERT_BITS, min_level, ranges);
+        sort(ranges.begin(), ranges.end());
+    }
+    Spans spans;
+    auto add_pieces=[&spans](size_t first, size_t last){
+        Spans more=pieces(first, last);
+        spans.insert(spans.end(), more.begin(), more.end());
+    };
+    for(size_t i=0; i<ranges.size(); i++){
+        //ranges that touch are one run of rows
+        uint64_t low=ranges[i].first, high=ranges[i].second;
+        while(i+1<ranges.size() && ranges[i+1].first==high+1)
+            high=ranges[++i].second;
+        size_t first=lower_bound(keys.begin(), keys.end(), low)-keys.begin();
+        add_pieces(first, upper_bound(keys.begin()+first, keys.end(), high)-
+                          keys.begin());
+    }
+    add_pieces(keys.size(), rows.size());
+    return spans;
+}
+
+const string &HotTrees::species_name(uint32_t species) const{
+    return species_names[species];
+}
+
+size_t HotTrees::heap_bytes() const{
+    size_t bytes=heap_block(rows.capacity()*sizeof(HotTree))+
+                 heap_block(species_names.capacity()*sizeof(string))+
+                 heap_block(species_rank.capacity()*sizeof(uint32_t))+
+                 heap_block(species_ids.bucket_count()*sizeof(void *))+
+                 heap_block(keys.capacity()*sizeof(uint32_t));
+    for(const auto &name:species_names)
+        bytes+=string_heap(name);
+    for(const auto &entry:species_ids)
+        bytes+=heap_block(HASH_NODE_OVERHEAD+sizeof(entry))+
+               string_heap(entry.first);
+    return bytes;
+}
+
+HotTrees::Spans HotTrees::pieces(size_t first, size_t last){
+    Spans spans;
+    for(size_t lo=first; lo<last; lo+=SCAN_GRAIN)
+        spans.push_back({lo, min(last, lo+SCAN_GRAIN)});
+    return spans;
+}
+
+uint32_t HotTrees::position_key(const HotTree &h){
+    return hilbert_key(hilbert_cell(h.longitude), hilbert_cell(h.latitude));
+}
+
+//numbers a new species and ranks the species again
+HotTree HotTrees::encode(const Tree &t){
+    auto it=species_ids.find(t.common_name());
+    if(it==species_ids.end()){
+        it=species_ids.emplace(t.common_name(), species_names.size()).first;
+        species_names.push_back(t.common_name());
+        rank_species();
+    }
+    HotTree h;
+    double lat, lon;
+    t.get_position(lat, lon);
+    bool exact=encode_coordinate(lat, LATITUDE_ORIGIN, h.latitude);
+    exact=encode_coordinate(lon, LONGITUDE_ORIGIN, h.longitude) && exact;
+    h.tree_id=t.id();
+    h.zipcode=t.zip_code();
+    h.species=it->second;
+    h.diameter=t.diameter();
+    h.codes=code_of(t.borough_name(), BOROUGH_NAMES, 5)|
+            code_of(t.life_status(), STATUS_NAMES, 4)<<4|
+            code_of(t.tree_health(), HEALTH_NAMES, 4)<<8|
+            (exact?HotTree::EXACT_POSITION:0)<<12;
+    return h;
+}
+
+//names that are equal but for case get the same rank, since operator<
+//files them as one name
+void HotTrees::rank_species(){
+    vector<uint32_t> order(species_names.size());
+    for(uint32_t s=0; s<order.size(); s++)
+        order[s]=s;
+    sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b){
+        return compare_lower(species_names[a], species_names[b])<0;
+    });
+    species_rank.assign(order.size(), 0);
+    for(size_t i=1; i<order.size(); i++)
+        species_rank[order[i]]=species_rank[order[i-1]]+
+            (compare_lower(species_names[order[i-1]],
+                           species_names[order[i]])<0?1:0);
+}
@@ -0,0 +1,315 @@
+/*******************************************************************************
+Title           : hot_trees.h
+Created on      : Oct 19, 2026
+Description     : Interface of the HotTree record and the HotTrees class
+Purpose         : Keeps the fields the zip code and distance scans read in
+                  small fixed-size records, one after the other, so that a
+                  scan streams through a few bytes per tree instead of
+                  chasing AVL nodes that hold whole Tree objects
+*******************************************************************************/
+
+#ifndef SW2_HOT_TREES_H_
+#define SW2_HOT_TREES_H_
+
+#include "../Tree/tree.h"
+#include "../AVLTree/packed_key.h"
+#include "../Scheduler/task_scheduler.h"
+
+using namespace std;
+
+/** Coordinates are kept as 32-bit counts of COORDINATE_UNIT degrees from an
+ *  origin in the middle of New York City. The census gives 8 decimals, and
+ *  32 bits of 1e-8 degrees reach 21 degrees from the origin, so every tree
+ *  of the city is kept exactly.
+ */
+const double COORDINATE_UNITS=1e8;
+const int64_t LATITUDE_ORIGIN=4070000000;     // 40.70 N
+const int64_t LONGITUDE_ORIGIN=-7395000000;   // 73.95 W
+
+/** encode_coordinate(degrees,origin,units) sets units to degrees as a count
+ *  of 1e-8 degrees from origin
+ *  @return bool true if decode_coordinate(units,origin) gives degrees back
+ *               exactly, false if degrees has more decimals than 8 or is too
+ *               far from the origin
+ */
+bool encode_coordinate(double degrees, int64_t origin, int32_t &units);
+
+/** decode_coordinate(units,origin) returns the degrees units stands for */
+inline double decode_coordinate(int32_t units, int64_t origin){
+    return (double)(origin+units)/COORDINATE_UNITS;
+}
+
+/** HotTree is the part of a tree the scans read, in 28 bytes:
+ *  the names, the address and the coordinates as doubles stay in the Tree.
+ *  codes holds four nibbles: the borough (its index in the order Bronx,
+ *  Manhattan, Brooklyn, Queens, Staten Island), the status and health
+ *  (their index in STATUS_NAMES and HEALTH_NAMES) and the flags.
+ */
+struct HotTree{
+    int32_t tree_id;
+    int32_t zipcode;
+    int32_t latitude;
+    int32_t longitude;
+    uint32_t species;
+    int32_t diameter;
+    uint16_t codes;
+
+    static const uint16_t EXACT_POSITION=1;
+    static const uint16_t REMOVED=2;
+
+    int borough() const{
+        return codes&15;
+    }
+
+    int status() const{
+        return codes>>4&15;
+    }
+
+    int health() const{
+        return codes>>8&15;
+    }
+
+    /** exact_position() is true if the coordinates decode to exactly the
+     *  doubles of the Tree, so that distances from them are the same
+     */
+    bool exact_position() const{
+        return (codes>>12&EXACT_POSITION)!=0;
+    }
+
+    /** removed() is true if the tree was removed but its record was left
+     *  in place to keep the rows in the order of their positions
+     */
+    bool removed() const{
+        return (codes>>12&REMOVED)!=0;
+    }
+
+    void get_position(double &lat, double &lon) const{
+        lat=decode_coordinate(latitude, LATITUDE_ORIGIN);
+        lon=decode_coordinate(longitude, LONGITUDE_ORIGIN);
+    }
+};
+
+/** PositionBox is a range of latitudes and of longitudes, in the units of
+ *  HotTree, both ends included
+ */
+struct PositionBox{
+    int32_t lat_lo, lat_hi;
+    int32_t lon_lo, lon_hi;
+
+    bool contains(const HotTree &h) const{
+        return h.latitude>=lat_lo && h.latitude<=lat_hi &&
+               h.longitude>=lon_lo && h.longitude<=lon_hi;
+    }
+};
+
+/** position_range(lat_lo,lat_hi,lon_lo,lon_hi) returns the box of the
+ *  positions from lat_lo to lat_hi and from lon_lo to lon_hi degrees,
+ *  rounded out to whole units and cut to what a HotTree can hold
+ */
+PositionBox position_range(double lat_lo, double lat_hi, double lon_lo,
+                           double lon_hi);
+
+/** position_box(lat,lon,lat_span,lon_span) returns the position_range of
+ *  the positions at most lat_span and lon_span degrees from (lat,lon), or
+ *  every position if (lat,lon) is more than 90 degrees from the origin or
+ *  not a number, where the spans of distance_bounds would not hold
+ */
+PositionBox position_box(double lat, double lon, double lat_span,
+                         double lon_span);
+
+/** The Hilbert curve goes through a grid of 2^HILBERT_BITS by 2^HILBERT_BITS
+ *  cells; a cell is 2^16 units, about 70 m, on a side.
+ */
+const int HILBERT_BITS=16;
+
+/** hilbert_cell(units) returns the column or row of the grid units is in */
+inline uint32_t hilbert_cell(int32_t units){
+    return (uint32_t)((int64_t)units-INT32_MIN)>>(32-HILBERT_BITS);
+}
+
+/** hilbert_key(x,y) returns how far along the Hilbert curve the cell in
+ *  column x and row y is. The cells of an aligned square of 2^k by 2^k
+ *  cells have consecutive keys, starting at a multiple of 4^k.
+ */
+uint32_t hilbert_key(uint32_t x, uint32_t y);
+
+extern const char *STATUS_NAMES[4];
+extern const char *HEALTH_NAMES[4];
+
+/** class HotTrees keeps a HotTree for every tree of a collection, in rows
+ *  that do not move except when a tree is removed or the rows are ordered.
+ *  Species are numbered as they first appear; their ranks, in the order of
+ *  their names, let the scans return trees in the order of the AVL tree
+ *  with integer compares.
+ *  After order_by_position() the rows with exact positions come first, in
+ *  the order of the Hilbert keys of their positions, so that the trees of a
+ *  PositionBox lie in a few runs of rows. Rows added later go after them
+ *  until the next order_by_position(), and removed rows among them are only
+ *  marked as removed.
+ */
+class HotTrees{
+    public:
+
+    HotTrees();
+
+    /** add(t) appends the record of t
+     *  @return uint32_t the row of the record
+     */
+    uint32_t add(const Tree &t);
+
+    /** remove(row) removes the record at row by moving the last record
+     *  there, or marks it as removed if it is one of the ordered rows
+     *  @return uint32_t the row the moved record came from, or row if no
+     *                   record moved
+     */
+    uint32_t remove(uint32_t row);
+
+    /** update(row,t) makes the record at row hold the fields of t again,
+     *  after its status, health or diameter changed
+     */
+    void update(uint32_t row, const Tree &t);
+
+    const HotTree &operator [](uint32_t row) const;
+
+    /** size() returns the number of records that are not removed */
+    size_t size() const;
+
+    /** order_by_position() puts the rows in the order of their positions
+     *  and keeps them in that order from now on; see needs_reorder()
+     *  @return vector<uint32_t> the new row of each old row, or NO_ROW for
+     *                           the removed ones
+     */
+    vector<uint32_t> order_by_position();
+
+    bool ordered_by_position() const;
+
+    /** needs_reorder() is true once the rows are ordered by position and so
+     *  many have been added or removed since that they should be ordered
+     *  again
+     */
+    bool needs_reorder() const;
+
+    static const uint32_t NO_ROW=UINT32_MAX;
+
+    /** species_name(s) returns the name of species number s */
+    const string &species_name(uint32_t species) const;
+
+    /** order_key(h) packs the rank of the species of h and its id, so that
+     *  the keys sort as the trees do in the AVL tree
+     */
+    uint64_t order_key(const HotTree &h) const{
+        return pack_tree_key(species_rank[h.species], h.tree_id);
+    }
+
+    /** find_rows(match) returns the rows r for which match(record,r) is
+     *  true, in the order of the trees in the AVL tree. The rows are
+     *  scanned in parallel, so match is called from several threads.
+     */
+    template <class Match>
+        vector<uint32_t> find_rows(Match match) const{
+            return scan(pieces(0, rows.size()), match);
+        }
+
+    /** find_rows_in(box,match) is find_rows(match) for a match that is
+     *  only true for records in box or records without an exact position.
+     *  Once the rows are ordered by position, it reads only the runs of
+     *  rows box_spans(box) returns.
+     */
+    template <class Match>
+        vector<uint32_t> find_rows_in(const PositionBox &box,
+                                      Match match) const{
+            return scan(box_spans(box), [&](const HotTree &h, uint32_t r){
+                return (!h.exact_position() || box.contains(h)) &&
+                       match(h, r);
+            });
+        }
+
+    /** reduce(identity,add,combine) gives every record that is not removed
+     *  to add(part,record,row), where part is a T of the span of rows being
+     *  read, starting from identity, and returns the parts combined with
+     *  combine(a,b). The spans are read in parallel, so add is called from
+     *  several threads, on different parts.
+     */
+    template <class T, class Add, class Combine>
+        T reduce(const T &identity, Add add, Combine combine) const{
+            Spans spans=pieces(0, rows.size());
+            return parallel_reduce(size_t(0), spans.size(), 1, identity,
+                [&](size_t lo, size_t hi){
+                    T part=identity;
+                    for(size_t s=lo; s<hi; s++)
+                        for(uint32_t r=spans[s].first; r<spans[s].second;
+                            r++)
+                            if(!rows[r].removed())
+                                add(part, rows[r], r);
+                    return part;
+                }, combine);
+        }
+
+    /** box_spans(box) returns the runs of rows [first,second) that hold
+     *  every record in box and every record without an exact position:
+     *  all of the rows until they are ordered by position
+     */
+    vector<pair<uint32_t, uint32_t>> box_spans(const PositionBox &box) const;
+
+    /** heap_bytes() returns the heap memory of the records and the species
+     *  table
+     */
+    size_t heap_bytes() const;
+
+    private:
+
+    static const size_t SCAN_GRAIN=16384;
+    static const size_t REORDER_MIN=4096;
+
+    typedef vector<pair<uint32_t, uint32_t>> Spans;
+
+    vector<HotTree> rows;
+    vector<string> species_names;
+    unordered_map<string, uint32_t> species_ids;
+    vector<uint32_t> species_rank;
+    bool by_position;
+    vector<uint32_t> keys;      // the Hilbert keys of the ordered rows
+    size_t added, removed;      // since the rows were ordered
+
+    /** scan(spans,match) returns the rows of spans that are not removed
+     *  and for which match is true, in the order of the AVL tree. The spans
+     *  are scanned in parallel.
+     */
+    template <class Match>
+        vector<uint32_t> scan(const Spans &spans, Match match) const{
+            typedef vector<pair<uint64_t, uint32_t>> Found;
+            Found found=parallel_reduce(size_t(0), spans.size(), 1, Found(),
+                [&](size_t lo, size_t hi){
+                    Found part;
+                    for(size_t s=lo; s<hi; s++)
+                        for(uint32_t r=spans[s].first; r<spans[s].second;
+                            r++)
+                            if(!rows[r].removed() && match(rows[r], r))
+                                part.push_back({order_key(rows[r]), r});
+                    return part;
+                },
+                [](Found a, const Found &b){
+                    a.insert(a.end(), b.begin(), b.end());
+                    return a;
+                });
+            sort(found.begin(), found.end());
+            vector<uint32_t> result;
+            result.reserve(found.size());
+            for(const auto &f:found)
+                result.push_back(f.second);
+            return result;
+        }
+
+    /** pieces(first,last) cuts the rows [first,last) into spans of at most
+     *  SCAN_GRAIN rows, the work of one task of scan()
+     */
+    static Spans pieces(size_t first, size_t last);
+
+    static uint32_t position_key(const HotTree &h);
+
+    HotTree encode(const Tree &t);
+
+    void rank_species();
+};
+
+#endif //SW2_HOT_TREES_H_
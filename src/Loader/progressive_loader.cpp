@@ -0,0 +1,94 @@
+/**
+    progressive_loader.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement progressive_loader class
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "progressive_loader.h"
+#include "tree_loader.h"
+#include "../Trace/trace.h"
+
+/****************************ProgressiveLoader Class***************************/
+
+ProgressiveLoader::ProgressiveLoader(TreeCollection &_trees,
+                                     size_t _publish_every): trees(_trees),
+                                     publish_every(_publish_every),
+                                     file_size(0){
+    publish(0, false);
+}
+
+ProgressiveLoader::~ProgressiveLoader(){
+    finish();
+}
+
+bool ProgressiveLoader::start(const string &path){
+    in.open(path);
+    if(in.fail())
+        return false;
+    in.seekg(0, ios::end);
+    file_size=double(in.tellg());
+    in.seekg(0, ios::beg);
+    loader=thread(&ProgressiveLoader::load, this);
+    return true;
+}
+
+shared_ptr<const LoadedTrees> ProgressiveLoader::latest() const{
+    return slot.acquire();
+}
+
+shared_ptr<const LoadedTrees> ProgressiveLoader::wait_for(double fraction)
+                                                                         const{
+    shared_ptr<const LoadedTrees> loaded;
+    unique_lock<mutex> guard(progress_lock);
+    progress.wait(guard, [&]{
+        loaded=slot.acquire();
+        return loaded->complete || (fraction<1 && loaded->fraction>=fraction);
+    });
+    return loaded;
+}
+
+void ProgressiveLoader::finish(){
+    if(loader.joinable())
+        loader.join();
+}
+
+//makes a snapshot of trees and hands it to the readers
+void ProgressiveLoader::publish(long rows, bool complete){
+    TRACE_SPAN("load", "publish snapshot");
+    auto loaded=make_shared<LoadedTrees>();
+    loaded->trees=trees.snapshot();
+    loaded->rows=rows;
+    loaded->complete=complete;
+    if(complete || file_size<=0)
+        loaded->fraction=complete?1:0;
+    else
+        loaded->fraction=min(1.0, max(0.0, double(in.tellg())/file_size));
+    {
+        lock_guard<mutex> guard(progress_lock);
+        slot.publish(loaded);
+    }
+    progress.notify_all();
+}
+
+//runs on the loader thread
+void ProgressiveLoader::load(){
+    TreeLoader chunks(trees, publish_every);
+    chunks.on_chunk([this](long rows){
+        if(in.peek()!=EOF)      //the last chunk is published as complete
+            publish(rows, false);
+    });
+    long rows=chunks.load(in);
+    publish(rows, true);
+    in.close();
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+Title           : progressive_loader.h
+Created on      : Oct 19, 2026
+Description     : Interface of the ProgressiveLoader class and of the
+                  LoadedTrees snapshots it publishes
+Purpose         : Lets commands run while the data file is still loading
+*******************************************************************************/
+
+#ifndef SW2_PROGRESSIVE_LOADER_H_
+#define SW2_PROGRESSIVE_LOADER_H_
+
+#include "../TreeCollection/tree_collection.h"
+#include "../Snapshot/snapshot_slot.h"
+
+using namespace std;
+
+/** struct LoadedTrees is one published state of a load: a read-only copy of
+ *  the collection and how much of the data file it covers
+ */
+struct LoadedTrees{
+    shared_ptr<const TreeCollection> trees;
+    long rows;          // lines of the data file read into trees
+    double fraction;    // part of the data file read, from 0 to 1
+    bool complete;      // true once the whole file is in trees
+};
+
+/** class ProgressiveLoader loads the data file on a background thread and
+ *  publishes a snapshot of the collection every publish_every lines, and
+ *  once more at the end. Readers take the latest snapshot without waiting
+ *  for the loader, or wait until a given part of the file is in.
+ */
+class ProgressiveLoader{
+    public:
+    
+    static const size_t PUBLISH_EVERY=50000;
+    
+    /** ProgressiveLoader(trees,publish_every) loads into trees, which no
+     *  other thread may use until finish() returns
+     */
+    explicit ProgressiveLoader(TreeCollection &trees,
+                               size_t publish_every=PUBLISH_EVERY);
+    
+    ProgressiveLoader(const ProgressiveLoader &)=delete;
+    
+    ProgressiveLoader &operator =(const ProgressiveLoader &)=delete;
+    
+    /** ~ProgressiveLoader() waits for the load to finish */
+    ~ProgressiveLoader();
+    
+    /** start(path) opens the data file and starts loading it
+     *  @return bool false if the file could not be opened
+     */
+    bool start(const string &path);
+    
+    /** latest() returns the latest snapshot; an empty one before the first
+     *  chunk is in
+     */
+    shared_ptr<const LoadedTrees> latest() const;
+    
+    /** wait_for(f) returns the first snapshot that covers at least the part
+     *  f of the data file; with f >= 1 it waits for the complete one
+     */
+    shared_ptr<const LoadedTrees> wait_for(double fraction) const;
+    
+    /** finish() waits for the load to finish; trees may be used after it */
+    void finish();
+    
+    private:
+    
+    TreeCollection &trees;
+    size_t publish_every;
+    ifstream in;
+    double file_size;
+    thread loader;
+    SnapshotSlot<LoadedTrees> slot;
+    mutable mutex progress_lock;
+    mutable condition_variable progress;
+    
+    void publish(long rows, bool complete);
+    
+    void load();
+};
+
+#endif //SW2_PROGRESSIVE_LOADER_H_
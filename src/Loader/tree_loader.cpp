@@ -0,0 +1,115 @@
+/**
+    tree_loader.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement tree_loader class; the load loop was moved here
+             from main.cpp
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "tree_loader.h"
+#include "../Scheduler/task_scheduler.h"
+#include "../Stats/run_stats.h"
+#include "../Trace/trace.h"
+
+// lines parsed by one task
+const size_t PARSE_GRAIN=1024;
+
+/****************************TreeLoader Class**********************************/
+
+TreeLoader::TreeLoader(TreeCollection &_trees, size_t _chunk_lines):
+                       trees(_trees), chunk_lines(max(_chunk_lines, size_t(1))),
+                       lines(0), added(0){}
+
+void TreeLoader::on_chunk(function<void(long)> f){
+    chunk_done=move(f);
+}
+
+long TreeLoader::load(istream &in){
+    TRACE_SPAN("load", "load");
+    vector<string> chunk(chunk_lines);
+    vector<Tree> parsed(chunk_lines);
+    long first_line=lines;
+    
+    RunStats &stats=RunStats::instance();
+    bool timed=stats.enabled();
+    uint64_t start=timed?now_ns():0, done;
+    
+    while(in){
+        size_t n=0;
+        long bytes=0;
+        {
+            TRACE_SPAN("load", "read lines");
+            CounterScope counted(stats.phase_counters(read_phase));
+            while(n<chunk_lines && getline(in, chunk[n]))
+                bytes+=chunk[n++].size()+1;
+        }
+        if(timed){
+            done=now_ns();
+            stats.record_phase(read_phase, done-start, n, bytes);
+            start=done;
+        }
+        
+        parallel_for(0, n, PARSE_GRAIN, [&](size_t lo, size_t hi){
+            TRACE_SPAN("load", "parse rows");
+            CounterScope counted(stats.phase_counters(parse_phase));
+            for(size_t i=lo; i<hi; i++)
+                parsed[i]=Tree(chunk[i]);
+        });
+        if(timed){
+            done=now_ns();
+            stats.record_phase(parse_phase, done-start, n);
+            start=done;
+        }
+        
+        long bad=0;
+        {
+            TRACE_SPAN("load", "validate rows");
+            CounterScope counted(stats.phase_counters(validate_phase));
+            for(size_t i=0; i<n; i++)
+                if(0==parsed[i].id()){
+                    cerr<<"bad data on line "<<lines+i+1<<endl;
+                    bad++;
+                }
+        }
+        if(timed){
+            done=now_ns();
+            stats.record_phase(validate_phase, done-start, n);
+            stats.record_bad_rows(bad);
+            start=done;
+        }
+        
+        {
+            TRACE_SPAN("load", "add_tree");
+            CounterScope counted(stats.phase_counters(insert_phase));
+            for(size_t i=0; i<n; i++)
+                if(0!=parsed[i].id())
+                    added+=trees.add_tree(move(parsed[i]));
+        }
+        lines+=n;
+        if(timed){
+            done=now_ns();
+            stats.record_phase(insert_phase, done-start, n);
+            start=done;
+        }
+        if(n>0 && chunk_done){
+            chunk_done(lines);
+            if(timed)
+                start=now_ns();
+        }
+    }
+    return lines-first_line;
+}
+
+long TreeLoader::trees_added() const{
+    return added;
+}
@@ -0,0 +1,55 @@
+/*******************************************************************************
+Title           : tree_loader.h
+Created on      : Oct 19, 2026
+Description     : Interface of the TreeLoader class
+Purpose         : Reads the census CSV file into a TreeCollection
+*******************************************************************************/
+
+#ifndef SW2_TREE_LOADER_H_
+#define SW2_TREE_LOADER_H_
+
+#include "../TreeCollection/tree_collection.h"
+
+using namespace std;
+
+/** class TreeLoader reads the data file in chunks of lines. The lines of a
+ *  chunk are parsed into Tree objects in parallel on the shared
+ *  TaskScheduler, and then added to the collection one by one, in file
+ *  order, so the collection and the "bad data" messages are the same as
+ *  those of a line by line load.
+ */
+class TreeLoader{
+    public:
+    
+    static const size_t CHUNK_LINES=1<<16;
+    
+    /** TreeLoader(trees,chunk_lines) reads chunk_lines lines per chunk */
+    explicit TreeLoader(TreeCollection &trees,
+                        size_t chunk_lines=CHUNK_LINES);
+    
+    /** on_chunk(f) makes load() call f(lines) after the trees of each chunk
+     *  are in the collection, where lines is the number of lines read so far
+     */
+    void on_chunk(function<void(long)> f);
+    
+    /** load(in) adds every valid line of in to the collection and reports
+     *  the invalid ones on cerr
+     *  @return long the number of lines read
+     */
+    long load(istream &in);
+    
+    /** trees_added() returns how many trees load() added so far; lines that
+     *  repeat a tree already in the collection are not counted
+     */
+    long trees_added() const;
+    
+    private:
+    
+    TreeCollection &trees;
+    size_t chunk_lines;
+    function<void(long)> chunk_done;
+    long lines;
+    long added;
+};
+
+#endif //SW2_TREE_LOADER_H_
@@ -0,0 +1,48 @@
+/**
+    memory_report.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement memory_report class and proc_status_kb()
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "memory_report.h"
+#include "../Executor/command_executor.h"
+#include "../ResultWriter/result_writer.h"
+
+/****************************Helper Functions**********************************/
+
+long proc_status_kb(const string &key){
+    ifstream status("/proc/self/status");
+    string line;
+    while(getline(status, line))
+        if(line.compare(0, key.size(), key)==0 && line.size()>key.size() &&
+           line[key.size()]==':')
+            return atol(line.c_str()+key.size()+1);
+    return -1;
+}
+
+/****************************MemoryReport Class********************************/
+
+MemoryReport::MemoryReport(const TreeCollection &_trees, bool _enabled,
+                           ostream &_out): trees(_trees), enabled(_enabled),
+                           out(_out){}
+
+MemoryReport::~MemoryReport(){
+    if(!enabled)
+        return;
+    istringstream text("memory_report\n");
+    Command command;
+    command.get_next(text);
+    TextResultWriter writer(out);
+    CommandExecutor(trees).execute(command, writer);
+}
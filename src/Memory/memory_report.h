@@ -0,0 +1,38 @@
+/*******************************************************************************
+Title           : memory_report.h
+Created on      : Oct 19, 2026
+Description     : Interface of the MemoryReport class
+Purpose         : Writes the memory_report table of a collection at the end of
+                  a run, for --mem-report
+*******************************************************************************/
+
+#ifndef SW2_MEMORY_REPORT_H_
+#define SW2_MEMORY_REPORT_H_
+
+#include "../TreeCollection/tree_collection.h"
+
+using namespace std;
+
+/** class MemoryReport writes what the memory_report command writes for
+ *  trees, as text on out, when it goes out of scope, if enabled is true.
+ *  trees must outlive it.
+ */
+class MemoryReport{
+    public:
+
+    MemoryReport(const TreeCollection &trees, bool enabled, ostream &out);
+
+    MemoryReport(const MemoryReport &)=delete;
+
+    MemoryReport &operator =(const MemoryReport &)=delete;
+
+    ~MemoryReport();
+
+    private:
+
+    const TreeCollection &trees;
+    bool enabled;
+    ostream &out;
+};
+
+#endif //SW2_MEMORY_REPORT_H_
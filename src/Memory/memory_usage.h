@@ -0,0 +1,56 @@
+/*******************************************************************************
+Title           : memory_usage.h
+Created on      : Oct 19, 2026
+Description     : Interface of the MemoryUsage struct and the heap size helpers
+Purpose         : Estimates how many bytes of memory the data structures take,
+                  counting what malloc really hands out for each allocation,
+                  so that the estimates can be held against the resident
+                  memory of the process
+*******************************************************************************/
+
+#ifndef SW2_MEMORY_USAGE_H_
+#define SW2_MEMORY_USAGE_H_
+
+using namespace std;
+
+/** MemoryUsage is one line of a memory report: a data structure, how many
+ *  items it holds and how many bytes of heap it takes
+ */
+struct MemoryUsage{
+    string structure;
+    long items;
+    size_t bytes;
+};
+
+/** The sizes of the nodes libstdc++ allocates for its containers: a map
+ *  node has a color and three links before the value, a list node two
+ *  links, and an unordered_map node of string keys a link and the cached
+ *  hash of the key.
+ */
+const size_t MAP_NODE_OVERHEAD=32;
+const size_t LIST_NODE_OVERHEAD=16;
+const size_t HASH_NODE_OVERHEAD=16;
+
+/** heap_block(n) returns the bytes a malloc(n) takes from the heap: glibc
+ *  adds an 8 byte header, rounds up to 16 and never gives less than 32
+ */
+inline size_t heap_block(size_t n){
+    if(n==0)
+        return 0;
+    size_t block=(n+8+15)&~size_t(15);
+    return block<32?32:block;
+}
+
+/** string_heap(s) returns the heap bytes behind s; strings of up to 15
+ *  characters are kept inside the string object and take none
+ */
+inline size_t string_heap(const string &s){
+    return s.capacity()>15?heap_block(s.capacity()+1):0;
+}
+
+/** proc_status_kb(key) returns a field of /proc/self/status such as
+ *  "VmRSS" or "VmHWM", in kB, or -1 if it cannot be read
+ */
+long proc_status_kb(const string &key);
+
+#endif //SW2_MEMORY_USAGE_H_
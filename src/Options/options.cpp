@@ -0,0 +1,186 @@
+/**
+    options.cpp
+    @version 1.0 10/19/26
+    Purpose: To parse the command line of the program
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "options.h"
+#include "../Loader/progressive_loader.h"
+
+/****************************Helper Functions**********************************/
+
+//if arg is "--name=value", stores value and returns true
+bool option_value(const string &arg, const string &name, string &value){
+    string key="--"+name+"=";
+    if(arg.compare(0, key.size(), key)!=0)
+        return false;
+    value=arg.substr(key.size());
+    return true;
+}
+
+//parses a count of at least 1 given to option name
+bool positive_value(const string &name, const string &value, size_t &count){
+    char *end;
+    long n=strtol(value.c_str(), &end, 10);
+    if(value.empty() || *end!='\0' || n<1){
+        cerr<<"--"<<name<<" needs a positive number"<<endl;
+        return false;
+    }
+    count=n;
+    return true;
+}
+
+//parses the part of the data file given to --wait-for, from 0 to 1
+bool fraction_value(const string &value, double &fraction){
+    char *end;
+    double f=strtod(value.c_str(), &end);
+    if(value.empty() || *end!='\0' || !(f>=0 && f<=1)){
+        cerr<<"--wait-for needs a number from 0 to 1"<<endl;
+        return false;
+    }
+    fraction=f;
+    return true;
+}
+
+/****************************Options*******************************************/
+
+bool parse_options(int argc, char *argv[], Options &options){
+    vector<string> files;
+    string value;
+    
+    for(int i=1; i<argc; i++){
+        string arg=argv[i];
+        if(option_value(arg, "format", value)){
+            if(value=="text") options.format=text_format;
+            else if(value=="jsonl") options.format=jsonl_format;
+            else if(value=="csv") options.format=csv_format;
+            else{
+                cerr<<"Unknown output format "<<value<<endl;
+                return false;
+            }
+        }
+        else if(option_value(arg, "serve", value) && !value.empty())
+            options.serve_socket=value;
+        else if(option_value(arg, "client", value) && !value.empty())
+            options.client_socket=value;
+        else if(option_value(arg, "threads", value)){
+            if(!positive_value("threads", value, options.threads))
+                return false;
+        }
+        else if(option_value(arg, "jobs", value) ||
+                (arg=="--jobs" && i+1<argc && (value=argv[++i], true))){
+            if(!positive_value("jobs", value, options.jobs))
+                return false;
+        }
+        else if(arg=="--progressive")
+            options.progressive=ProgressiveLoader::PUBLISH_EVERY;
+        else if(option_value(arg, "progressive", value)){
+            if(!positive_value("progressive", value, options.progressive))
+                return false;
+        }
+        else if(option_value(arg, "wait-for", value)){
+            if(!fraction_value(value, options.wait_for))
+                return false;
+            if(options.progressive==0)
+                options.progressive=ProgressiveLoader::PUBLISH_EVERY;
+        }
+        else if(option_value(arg, "log", value) && !value.empty())
+            options.log_file=value;
+        else if(option_value(arg, "compact-every", value)){
+            if(!positive_value("compact-every", value, options.compact_every))
+                return false;
+        }
+        else if(arg=="--stats")
+            options.stats=text_stats;
+        else if(option_value(arg, "stats", value)){
+            if(value=="text") options.stats=text_stats;
+            else if(value=="json") options.stats=json_stats;
+            else{
+                cerr<<"Unknown stats format "<<value<<endl;
+                return false;
+            }
+        }
+        else if(arg=="--counters")
+            options.counters=true;
+        else if(arg=="--mem-report")
+            options.mem_report=true;
+        else if(option_value(arg, "trace", value) && !value.empty())
+            options.trace_file=value;
+        else if(arg=="--spatial-order")
+            options.spatial_order=true;
+        else if(arg.compare(0, 2, "--")==0){
+            cerr<<"Unknown option "<<arg<<endl;
+            return false;
+        }
+        else files.push_back(arg);
+    }
+    if(!options.serve_socket.empty() && !options.client_socket.empty()){
+        cerr<<"--serve and --client cannot be used together"<<endl;
+        return false;
+    }
+    if(options.progressive>0 && (options.jobs>1 ||
+                                 !options.serve_socket.empty() ||
+                                 !options.client_socket.empty())){
+        cerr<<"--progressive only works with the serial command loop"<<endl;
+        return false;
+    }
+    if(!options.log_file.empty() && (options.progressive>0 ||
+                                     !options.client_socket.empty())){
+        cerr<<"--log cannot be used with --progressive or --client"<<endl;
+        return false;
+    }
+    if(options.counters && options.stats==no_stats)
+        options.stats=text_stats;
+    if((options.stats!=no_stats || options.mem_report ||
+        !options.trace_file.empty() || options.spatial_order) &&
+       !options.client_socket.empty()){
+        cerr<<"--stats, --counters, --mem-report, --trace and --spatial-order"
+              " cannot be used\nwith --client; the server runs the commands"
+            <<endl;
+        return false;
+    }
+    if(!options.serve_socket.empty()){
+        if(files.size()!=1)
+            return false;
+        options.input_file=files[0];
+    }
+    else if(!options.client_socket.empty()){
+        if(files.size()!=1)
+            return false;
+        options.command_file=files[0];
+    }
+    else{
+        if(files.size()!=2)
+            return false;
+        options.input_file=files[0];
+        options.command_file=files[1];
+    }
+    return true;
+}
+
+void usage(const char *program){
+    cerr<<"\n Usage: "<<program
+        <<" [--format=text|jsonl|csv] [--jobs N] [--log=file"
+        <<" [--compact-every=N]]\n            [--stats[=text|json]]"
+        <<" [--counters] [--mem-report] [--trace=file.json]\n           "
+        <<" [--spatial-order] input_file  command_file"
+        <<"\n        "<<program
+        <<" [--format=text|jsonl|csv] --progressive[=rows] [--wait-for=0..1]"
+        <<" input_file  command_file"
+        <<"\n        "<<program
+        <<" [--format=text|jsonl|csv] [--threads=N] --serve=socket input_file"
+        <<"\n        "<<program<<" --client=socket command_file"
+        <<"\n --stats[=text|json], --counters, --mem-report, --trace and"
+        <<" --spatial-order work in\n all but the last form"<<endl;
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************
+Title           : options.h
+Created on      : Oct 19, 2026
+Description     : The command line options of the program
+*******************************************************************************/
+
+#ifndef SW2_OPTIONS_H_
+#define SW2_OPTIONS_H_
+
+#include "../ResultWriter/__result_writer.h"
+#include "../Stats/run_stats.h"
+
+using namespace std;
+
+/** struct Options holds what was given on the command line, one of
+ *      [--format=F] [--jobs N] input_file command_file
+ *      [--format=F] --progressive[=K] [--wait-for=F] input_file command_file
+ *  where the first two, and --serve, also take [--log=FILE [--compact-every=N]]
+ *      [--format=F] [--threads=N] --serve=SOCKET input_file
+ *      --client=SOCKET command_file
+ *  All but --client also take [--stats[=text|json]], [--counters],
+ *  [--mem-report], [--trace=FILE] and [--spatial-order]; --counters
+ *  implies --stats.
+ *  Options may appear before, between or after the file names.
+ */
+struct Options{
+    string input_file;
+    string command_file;
+    Output_format format=text_format;
+    string serve_socket;        // non-empty in server mode
+    string client_socket;       // non-empty in client mode
+    size_t threads=0;           // 0 means one per hardware thread
+    size_t jobs=1;              // commands run at once; 1 is the serial loop
+    size_t progressive=0;       // rows per snapshot while loading; 0 is off
+    double wait_for=0;          // part of the data file to wait for
+    string log_file;            // change log; empty for none
+    size_t compact_every=10000; // changes between two compactions
+    Stats_format stats=no_stats;  // written on cerr at exit
+    bool counters=false;        // hardware counters in the stats
+    bool mem_report=false;      // memory_report on cerr at exit
+    string trace_file;          // Chrome trace written at exit; empty for none
+    bool spatial_order=false;   // hot records in Hilbert order
+};
+
+/** parse_options(argc,argv,options) fills options from the command line
+ *  @return bool  false, after printing the reason on cerr, if the command
+ *                line is not valid
+ */
+bool parse_options(int argc, char *argv[], Options &options);
+
+/** usage(program) prints how to run the program on cerr */
+void usage(const char *program);
+
+#endif //SW2_OPTIONS_H_
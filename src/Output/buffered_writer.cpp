@@ -0,0 +1,153 @@
+/**
+    buffered_writer.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement buffered_writer class
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "buffered_writer.h"
+
+//large enough for any long or any double printed by this program
+const size_t MAX_NUMBER_LENGTH=352;
+
+/****************************Helper Functions**********************************/
+
+//formats value into buf with ',' between digit groups; returns the length
+size_t format_grouped(char *buf, long value){
+    char digits[24];
+    char *end=to_chars(digits, digits+sizeof(digits), value).ptr;
+    char *first=digits;
+    size_t n=0;
+    if(*first=='-')
+        buf[n++]=*first++;
+    size_t count=end-first;
+    for(size_t i=0; i<count; i++){
+        if(i>0 && (count-i)%3==0)
+            buf[n++]=',';
+        buf[n++]=first[i];
+    }
+    return n;
+}
+
+/****************************BufferedWriter Class******************************/
+
+BufferedWriter::BufferedWriter(ostream &_out, size_t capacity): out(_out),
+        buffer(max(capacity, MAX_NUMBER_LENGTH)), used(0), flushed(0){}
+
+BufferedWriter::~BufferedWriter(){
+    flush();
+}
+
+BufferedWriter &BufferedWriter::put(char c){
+    reserve(1);
+    buffer[used++]=c;
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write(const char *s, size_t n){
+    if(n>buffer.size()){     //too big to buffer; hand it over directly
+        flush();
+        out.write(s, n);
+        flushed+=n;
+        return *this;
+    }
+    reserve(n);
+    memcpy(buffer.data()+used, s, n);
+    used+=n;
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write(const string &s){
+    return write(s.data(), s.size());
+}
+
+BufferedWriter &BufferedWriter::write_int(long value){
+    reserve(MAX_NUMBER_LENGTH);
+    char *first=buffer.data()+used;
+    used=to_chars(first, first+MAX_NUMBER_LENGTH, value).ptr-buffer.data();
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write_grouped(long value){
+    reserve(MAX_NUMBER_LENGTH);
+    used+=format_grouped(buffer.data()+used, value);
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write_fixed(double value, int precision){
+    reserve(MAX_NUMBER_LENGTH);
+    char *first=buffer.data()+used;
+    used=to_chars(first, first+MAX_NUMBER_LENGTH, value, chars_format::fixed,
+                  precision).ptr-buffer.data();
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write_double(double value){
+    reserve(MAX_NUMBER_LENGTH);
+    char *first=buffer.data()+used;
+    used=to_chars(first, first+MAX_NUMBER_LENGTH, value).ptr-buffer.data();
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write_left(const string &s, size_t width){
+    write(s);
+    if(s.size()<width) pad(width-s.size());
+    return *this;
+}
+
+BufferedWriter &BufferedWriter::write_right(const char *s, size_t n,
+                                            size_t width){
+    if(n<width) pad(width-n);
+    return write(s, n);
+}
+
+BufferedWriter &BufferedWriter::write_grouped_right(long value, size_t width){
+    char buf[MAX_NUMBER_LENGTH];
+    return write_right(buf, format_grouped(buf, value), width);
+}
+
+BufferedWriter &BufferedWriter::write_fixed_right(double value, int precision,
+                                                  size_t width){
+    char buf[MAX_NUMBER_LENGTH];
+    char *last=to_chars(buf, buf+sizeof(buf), value, chars_format::fixed,
+                        precision).ptr;
+    return write_right(buf, last-buf, width);
+}
+
+void BufferedWriter::flush(){
+    if(used>0){
+        out.write(buffer.data(), used);
+        flushed+=used;
+        used=0;
+    }
+}
+
+size_t BufferedWriter::bytes_written() const{
+    return flushed+used;
+}
+
+//makes room for n more bytes, flushing the buffer if it is too full
+void BufferedWriter::reserve(size_t n){
+    if(used+n>buffer.size())
+        flush();
+}
+
+void BufferedWriter::pad(size_t n){
+    while(n>0){
+        reserve(1);
+        size_t step=min(n, buffer.size()-used);
+        memset(buffer.data()+used, ' ', step);
+        used+=step;
+        n-=step;
+    }
+}
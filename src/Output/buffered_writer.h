@@ -0,0 +1,89 @@
+/*******************************************************************************
+Title           : buffered_writer.h
+Created on      : Oct 19, 2026
+Description     : Interface of the BufferedWriter class
+Purpose         : Formats large results into a reusable buffer and hands it
+                  to an ostream in big blocks, instead of going through the
+                  stream's formatting and flushing once per row.
+*******************************************************************************/
+
+#ifndef SW2_BUFFERED_WRITER_H_
+#define SW2_BUFFERED_WRITER_H_
+
+using namespace std;
+
+/** class BufferedWriter collects output in a buffer of fixed capacity and
+ *  writes it to the stream given to the constructor whenever the buffer
+ *  fills, when flush() is called, and on destruction.
+ *  Numbers are formatted with to_chars, so the stream's flags, precision and
+ *  locale are neither used nor changed. The output is the same as what the
+ *  stream would produce with the classic locale, fixed notation for doubles,
+ *  and setw for the padded fields.
+ */
+class BufferedWriter{
+    public:
+    
+    static const size_t DEFAULT_CAPACITY=1<<20;
+    
+    explicit BufferedWriter(ostream &out, size_t capacity=DEFAULT_CAPACITY);
+    
+    BufferedWriter(const BufferedWriter &)=delete;
+    
+    BufferedWriter &operator =(const BufferedWriter &)=delete;
+    
+    /** ~BufferedWriter() flushes what is left in the buffer */
+    ~BufferedWriter();
+    
+    BufferedWriter &put(char c);
+    
+    BufferedWriter &write(const char *s, size_t n);
+    
+    BufferedWriter &write(const string &s);
+    
+    BufferedWriter &write_int(long value);
+    
+    /** write_grouped(v) writes v with a ',' between groups of three digits */
+    BufferedWriter &write_grouped(long value);
+    
+    /** write_fixed(v,p) writes v in fixed notation with p decimals */
+    BufferedWriter &write_fixed(double value, int precision);
+    
+    /** write_double(v) writes the shortest text that reads back as v */
+    BufferedWriter &write_double(double value);
+    
+    /** write_left(s,w) writes s padded with blanks on the right to width w */
+    BufferedWriter &write_left(const string &s, size_t width);
+    
+    /** write_right(s,w) writes s padded with blanks on the left to width w */
+    BufferedWriter &write_right(const char *s, size_t n, size_t width);
+    
+    /** write_grouped_right(v,w) writes v as write_grouped() does, padded
+     *  with blanks on the left to width w
+     */
+    BufferedWriter &write_grouped_right(long value, size_t width);
+    
+    /** write_fixed_right(v,p,w) writes v as write_fixed() does, padded with
+     *  blanks on the left to width w
+     */
+    BufferedWriter &write_fixed_right(double value, int precision,
+                                      size_t width);
+    
+    /** flush() hands the buffered bytes to the stream */
+    void flush();
+    
+    /** bytes_written() returns the number of bytes written so far */
+    size_t bytes_written() const;
+    
+    private:
+    
+    ostream &out;
+    vector<char> buffer;
+    size_t used;
+    size_t flushed;
+    
+    void reserve(size_t n);
+    
+    void pad(size_t n);
+};
+
+#endif //SW2_BUFFERED_WRITER_H_
@@ -0,0 +1,201 @@
+/**
+    polygon.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement polygon class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "polygon.h"
+
+const size_t EDGES_PER_BAND=2;
+const size_t MAX_BANDS=1<<16;
+
+typedef vector<pair<double, double>> Ring;      // latitude, longitude
+
+/****************************Helper Functions**********************************/
+
+//skips blanks and returns the next character, or '\0' at the end
+char next_char(const char *&p){
+    while(isspace((unsigned char)*p))
+        p++;
+    return *p;
+}
+
+//moves past c if it comes next
+bool take(const char *&p, char c){
+    if(next_char(p)!=c)
+        return false;
+    p++;
+    return true;
+}
+
+//returns the next word in upper case, or "" if a word does not come next
+string take_word(const char *&p){
+    string word;
+    next_char(p);
+    while(isalpha((unsigned char)*p))
+        word+=toupper((unsigned char)*p++);
+    return word;
+}
+
+//reads "(lon lat, lon lat, ...)", skipping any Z and M values
+bool read_ring(const char *&p, Ring &ring){
+    if(!take(p, '('))
+        return false;
+    do{
+        double values[2];
+        int n=0;
+        char *end;
+        for(char c=next_char(p); c!=',' && c!=')'; c=next_char(p)){
+            double value=strtod(p, &end);
+            if(end==p || !isfinite(value))
+                return false;
+            if(n<2)
+                values[n]=value;
+            n++;
+            p=end;
+        }
+        if(n<2)
+            return false;
+        ring.push_back({values[1], values[0]});
+    }while(take(p, ','));
+    return take(p, ')') && ring.size()>=3;
+}
+
+//reads "(ring, ring, ...)"
+bool read_rings(const char *&p, vector<Ring> &rings){
+    if(!take(p, '('))
+        return false;
+    do{
+        rings.emplace_back();
+        if(!read_ring(p, rings.back()))
+            return false;
+    }while(take(p, ','));
+    return take(p, ')');
+}
+
+/****************************Polygon Class*************************************/
+
+Polygon::Polygon(){
+    clear();
+}
+
+bool Polygon::read_wkt(const string &text){
+    clear();
+    const char *p=text.c_str();
+    string kind=take_word(p);
+    string dimensions=take_word(p);
+    if(dimensions!="" && dimensions!="Z" && dimensions!="M" &&
+       dimensions!="ZM")
+        return false;
+    vector<Ring> rings;
+    bool read=false;
+    if(kind=="POLYGON")
+        read=read_rings(p, rings);
+    else if(kind=="MULTIPOLYGON" && take(p, '(')){
+        do
+            read=read_rings(p, rings);
+        while(read && take(p, ','));
+        read=read && take(p, ')');
+    }
+    if(!read || next_char(p)!='\0')
+        return false;
+
+    lat_lo=lon_lo=INFINITY;
+    lat_hi=lon_hi=-INFINITY;
+    for(const auto &ring:rings)
+        for(size_t i=0; i<ring.size(); i++){
+            const auto &a=ring[i], &b=ring[(i+1)%ring.size()];
+            edge_list.push_back({a.first, a.second, b.first, b.second});
+            lat_lo=min(lat_lo, a.first);
+            lat_hi=max(lat_hi, a.first);
+            lon_lo=min(lon_lo, a.second);
+            lon_hi=max(lon_hi, a.second);
+        }
+    file_edges();
+    return true;
+}
+
+bool Polygon::empty() const{
+    return edge_list.empty();
+}
+
+size_t Polygon::edges() const{
+    return edge_list.size();
+}
+
+void Polygon::get_bounds(double &_lat_lo, double &_lat_hi, double &_lon_lo,
+                         double &_lon_hi) const{
+    _lat_lo=lat_lo;
+    _lat_hi=lat_hi;
+    _lon_lo=lon_lo;
+    _lon_hi=lon_hi;
+}
+
+bool Polygon::contains(double lat, double lon) const{
+    if(!(lat>=lat_lo && lat<=lat_hi && lon>=lon_lo && lon<=lon_hi))
+        return false;
+    size_t b=band(lat);
+    bool inside=false;
+    for(uint32_t i=band_start[b]; i<band_start[b+1]; i++){
+        const Edge &e=edge_list[band_edges[i]];
+        if((e.lat0>lat)!=(e.lat1>lat) &&
+           lon<e.lon0+(lat-e.lat0)*(e.lon1-e.lon0)/(e.lat1-e.lat0))
+            inside=!inside;
+    }
+    return inside;
+}
+
+//the band of lat; it never decreases as lat grows, so an edge is in every
+//band from that of its lower end to that of its upper end
+size_t Polygon::band(double lat) const{
+    if(!(band_height>0))
+        return 0;
+    double b=(lat-lat_lo)/band_height;
+    if(!(b>0))
+        return 0;
+    return min((size_t)b, band_count-1);
+}
+
+void Polygon::file_edges(){
+    band_count=min(max(edge_list.size()/EDGES_PER_BAND, size_t(1)),
+                   MAX_BANDS);
+    band_height=(lat_hi-lat_lo)/band_count;
+    band_start.assign(band_count+2, 0);
+    //count the edges of each band in band_start[b+2], then turn the counts
+    //into where each band starts as the edges are put in place
+    for(const auto &e:edge_list)
+        for(size_t b=band(min(e.lat0, e.lat1)); b<=band(max(e.lat0, e.lat1));
+            b++)
+            band_start[b+2]++;
+    for(size_t b=2; b<band_start.size(); b++)
+        band_start[b]+=band_start[b-1];
+    band_edges.resize(band_start.back());
+    for(uint32_t i=0; i<edge_list.size(); i++){
+        const Edge &e=edge_list[i];
+        for(size_t b=band(min(e.lat0, e.lat1)); b<=band(max(e.lat0, e.lat1));
+            b++)
+            band_edges[band_start[b+1]++]=i;
+    }
+    band_start.pop_back();
+}
+
+void Polygon::clear(){
+    edge_list.clear();
+    band_start.assign(2, 0);
+    band_edges.clear();
+    band_count=1;
+    lat_lo=lon_lo=INFINITY;
+    lat_hi=lon_hi=-INFINITY;
+    band_height=0;
+}
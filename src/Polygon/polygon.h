@@ -0,0 +1,70 @@
+/*******************************************************************************
+Title           : polygon.h
+Created on      : Oct 19, 2026
+Description     : Interface of the Polygon class
+Purpose         : Reads the WKT polygons of community districts and parks,
+                  and tells whether a point is inside one without looking at
+                  every edge
+*******************************************************************************/
+
+#ifndef SW2_POLYGON_H_
+#define SW2_POLYGON_H_
+
+using namespace std;
+
+/** class Polygon is a WKT POLYGON or MULTIPOLYGON: rings of points given as
+ *  longitude then latitude, as WKT has them. A point is inside if a line
+ *  from it to the east crosses the rings an odd number of times, so holes
+ *  and separate parts both work. The edges are filed in bands of latitude,
+ *  and contains() only looks at the edges of the band its point is in.
+ */
+class Polygon{
+    public:
+
+    Polygon();
+
+    /** read_wkt(text) makes the polygon the POLYGON or MULTIPOLYGON in text.
+     *  Z and M values are ignored.
+     *  @return bool false, leaving the polygon empty, if text is not one of
+     *               them or a ring has fewer than 3 points
+     */
+    bool read_wkt(const string &text);
+
+    bool empty() const;
+
+    /** edges() returns the number of edges of all the rings */
+    size_t edges() const;
+
+    /** get_bounds(lat_lo,lat_hi,lon_lo,lon_hi) sets its arguments to the
+     *  smallest box that holds the polygon
+     */
+    void get_bounds(double &lat_lo, double &lat_hi, double &lon_lo,
+                    double &lon_hi) const;
+
+    /** contains(lat,lon) returns true if (lat,lon) is inside the polygon.
+     *  Points outside the bounds are turned away before any edge is read.
+     */
+    bool contains(double lat, double lon) const;
+
+    private:
+
+    struct Edge{
+        double lat0, lon0;
+        double lat1, lon1;
+    };
+
+    vector<Edge> edge_list;
+    vector<uint32_t> band_edges;    // the edges of each band, band by band
+    vector<uint32_t> band_start;    // where the edges of each band start
+    size_t band_count;
+    double lat_lo, lat_hi, lon_lo, lon_hi;
+    double band_height;
+
+    size_t band(double lat) const;
+
+    void file_edges();
+
+    void clear();
+};
+
+#endif //SW2_POLYGON_H_
@@ -0,0 +1,126 @@
+/*******************************************************************************
+  Title          : __result_writer.h
+  Created on     : Oct 19, 2026
+  Description    : The interface file for the __ResultWriter abstract class
+  Purpose        : Separates what a command finds from how it is printed, so
+                   that the same results can be written as the human
+                   oriented text tables or as one record per row for
+                   programs.
+*******************************************************************************/
+
+#ifndef ___Result_Writer_H__
+#define ___Result_Writer_H__
+
+#include "../Tree/tree.h"
+#include "../Command/command.h"
+#include "../Analytics/diversity.h"
+#include "../Analytics/nearest_neighbors.h"
+
+using namespace std;
+
+/** Output_format:
+    An enumerated type to represent the formats a __ResultWriter can produce.
+*/
+typedef enum{
+    text_format=0,
+    jsonl_format,
+    csv_format,
+    num_Output_formats
+}Output_format;
+
+/** class __ResultWriter is an abstract class that receives the results of
+ *  the commands one row at a time. Each command's rows are bracketed by a
+ *  call to begin_command() and a call to end_command(). Between the two,
+ *  the rows arrive in the order in which the text format prints them.
+ */
+class __ResultWriter{
+    public:
+    
+    virtual ~__ResultWriter() = default;
+    
+    /** begin_command(c) starts the results of command c
+     *  @param Command c [in] the command whose results follow
+     */
+    virtual void begin_command(const Command &command) = 0;
+    
+    /** coverage(rows,complete) tells which part of the data file the
+     *  results of the current command are based on. It is only called while
+     *  the data file is still loading (see ProgressiveLoader), right after
+     *  begin_command().
+     *  @param long rows     [in] data file rows loaded
+     *  @param bool complete [in] true if that is the whole file
+     */
+    virtual void coverage(long rows, bool complete) = 0;
+    
+    /** end_command() ends the results of the current command */
+    virtual void end_command() = 0;
+    
+    /** species(s) writes one species name, either one matching tree_info or
+     *  one of the names printed by listall_names
+     */
+    virtual void species(const string &name) = 0;
+    
+    /** changed(n) reports that a change command changed n trees */
+    virtual void changed(int trees) = 0;
+    
+    /** no_matching_species() reports that tree_info matched no species */
+    virtual void no_matching_species() = 0;
+    
+    /** popularity(r,c,t,p) writes one row of the tree_info table
+     *  @param string region     [in] "New York City" or a borough name
+     *  @param int    count      [in] matching trees in the region
+     *  @param int    total      [in] all trees in the region
+     *  @param double percentage [in] 100 * count / total, or 0
+     */
+    virtual void popularity(const string &region, int count, int total,
+                            double percentage) = 0;
+    
+    /** frequency(s,n) writes one row of a species frequency table */
+    virtual void frequency(const string &name, long count) = 0;
+    
+    /** estimate(s,n,e) writes one row of the species frequency table of a
+     *  list_near estimate: n trees of species s, give or take e
+     */
+    virtual void estimate(const string &name, long count, long error) = 0;
+    
+    /** memory(s,n,b,p) writes one row of the memory_report table
+     *  @param string structure [in] the data structure, or a line of
+     *                               /proc/self/status such as "VmRSS"
+     *  @param long   items     [in] the items the structure holds
+     *  @param long   bytes     [in] the bytes it takes
+     *  @param double per_tree  [in] bytes divided by the number of trees
+     */
+    virtual void memory(const string &structure, long items, long bytes,
+                        double per_tree) = 0;
+    
+    /** cell(x,y,n) writes one cell of a heatmap
+     *  @param int  x     [in] the column of the cell, counted to the east
+     *  @param int  y     [in] the row of the cell, counted to the north
+     *  @param long count [in] the trees in the cell
+     */
+    virtual void cell(int x, int y, long count) = 0;
+    
+    /** diversity(d) writes the species diversity of one zip code or grid
+     *  cell
+     */
+    virtual void diversity(const Diversity &d) = 0;
+    
+    /** nearest(s) writes how far the trees of a species are from their
+     *  nearest neighbors of the same species
+     */
+    virtual void nearest(const NearestStats &stats) = 0;
+    
+    /** tree(t) writes one stored tree */
+    virtual void tree(const Tree &t) = 0;
+    
+    /** no_such_tree(id) reports that tree_by_id found nothing */
+    virtual void no_such_tree(int id) = 0;
+    
+    /** no_trees() reports that print_all found an empty collection */
+    virtual void no_trees() = 0;
+    
+    /** flush() hands everything written so far to the underlying stream */
+    virtual void flush() = 0;
+};
+
+#endif /* ___Result_Writer_H__ */
@@ -0,0 +1,716 @@
+/**
+    result_writer.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement the text, JSON Lines and CSV result writers
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "result_writer.h"
+
+/****************************Helper Functions**********************************/
+
+const char *command_name(Command_type type){
+    switch(type){
+        case tree_info_cmmd:return "tree_info";
+        case listall_names_cmmd:return "listall_names";
+        case listall_inzip_cmmd:return "listall_inzip";
+        case list_near_cmmd:return "list_near";
+        case print_all_cmmd:return "print_all";
+        case remove_stumps_cmmd:return "remove_stumps";
+        case tree_by_id_cmmd:return "tree_by_id";
+        case add_tree_cmmd:return "add_tree";
+        case update_tree_cmmd:return "update_tree";
+        case delete_tree_cmmd:return "delete_tree";
+        case memory_report_cmmd:return "memory_report";
+        case list_in_box_cmmd:return "list_in_box";
+        case list_in_polygon_cmmd:return "list_in_polygon";
+        case heatmap_cmmd:return "heatmap";
+        case diversity_cmmd:return "diversity";
+        case nearest_same_species_cmmd:return "nearest_same_species_stats";
+        case bad_cmmd:return "bad_command";
+        default:return "";
+    }
+}
+
+//the word that asks list_near for mode
+const char *near_mode_name(Near_mode mode){
+    switch(mode){
+        case approximate_near:return "approximate";
+        case estimate_near:return "estimate";
+        default:return "exact";
+    }
+}
+
+//removes the blanks tree_info keeps around its argument
+string trim(const string &s){
+    size_t first=s.find_first_not_of(" \t\r");
+    if(first==string::npos) return "";
+    return s.substr(first, s.find_last_not_of(" \t\r")-first+1);
+}
+
+//appends s to dst as a JSON string literal
+void append_json_string(string &dst, const string &s){
+    static const char hex[]="0123456789abcdef";
+    dst+='"';
+    for(unsigned char c:s){
+        if(c=='"' || c=='\\'){
+            dst+='\\';
+            dst+=c;
+        }
+        else if(c<0x20){
+            dst+="\\u00";
+            dst+=hex[c>>4];
+            dst+=hex[c&15];
+        }
+        else
+            dst+=c;
+    }
+    dst+='"';
+}
+
+unique_ptr<__ResultWriter> make_result_writer(Output_format format,
+                                              ostream &out, long seq){
+    switch(format){
+        case jsonl_format:return make_unique<JsonlResultWriter>(out, seq);
+        case csv_format:return make_unique<CsvResultWriter>(out, seq);
+        default:return make_unique<TextResultWriter>(out);
+    }
+}
+
+/****************************TextResultWriter Class****************************/
+
+TextResultWriter::TextResultWriter(ostream &_out): out(_out), type(null_cmmd),
+                                                   header_done(false){}
+
+void TextResultWriter::begin_command(const Command &command){
+    string treename;
+    int zipcode, offset, limit, cell_m;
+    double latitude, longitude, distance, latitude2, longitude2;
+    bool result;
+    
+    type=command.type_of();
+    header_done=false;
+    command.get_args(treename, zipcode, latitude, longitude, distance, result);
+    out.write("Command: ", 9);
+    switch(type){
+        case tree_info_cmmd:
+            out.write("tree_info ", 10).write(treename);
+            break;
+        case listall_inzip_cmmd:
+            out.write("listall_inzip ", 14).write_int(zipcode);
+            break;
+        case list_near_cmmd:
+            out.write("list_near ", 10).write_fixed(latitude, 6).put(' ')
+               .write_fixed(longitude, 6).put(' ').write_fixed(distance, 6);
+            if(command.near_mode()!=exact_near)
+                out.put(' ').write(near_mode_name(command.near_mode()));
+            break;
+        case list_in_box_cmmd:
+            command.get_box(latitude, longitude, latitude2, longitude2);
+            out.write("list_in_box ", 12).write_fixed(latitude, 6).put(' ')
+               .write_fixed(longitude, 6).put(' ').write_fixed(latitude2, 6)
+               .put(' ').write_fixed(longitude2, 6);
+            break;
+        case list_in_polygon_cmmd:
+            out.write("list_in_polygon ", 16).write(command.polygon_file());
+            break;
+        case heatmap_cmmd:
+            command.get_heatmap(cell_m, treename);
+            out.write("heatmap ", 8).write_int(cell_m);
+            if(!treename.empty())
+                out.put(' ').write(treename);
+            break;
+        case diversity_cmmd:
+            command.get_diversity(cell_m);
+            if(cell_m==0)
+                out.write("diversity zip", 13);
+            else
+                out.write("diversity grid ", 15).write_int(cell_m);
+            break;
+        case nearest_same_species_cmmd:
+            out.write("nearest_same_species_stats ", 27).write(treename);
+            break;
+        case print_all_cmmd:
+            command.get_page(offset, limit);
+            out.write("print_all", 9);
+            if(limit>=0)
+                out.put(' ').write_int(offset).put(' ').write_int(limit);
+            break;
+        case tree_by_id_cmmd:
+            out.write("tree_by_id ", 11).write_int(command.tree_id());
+            break;
+        case listall_names_cmmd:
+        case remove_stumps_cmmd:
+        case memory_report_cmmd:
+            out.write(command_name(type));
+            break;
+        case add_tree_cmmd:
+        case update_tree_cmmd:
+        case delete_tree_cmmd:
+            out.write(command.change_text());
+            break;
+        default:
+            return;      //bad and null commands echo nothing
+    }
+    out.put('\n');
+}
+
+void TextResultWriter::coverage(long rows, bool complete){
+    if(type==bad_cmmd || type==null_cmmd)
+        return;
+    out.write("Rows loaded: ", 13).write_int(rows)
+       .write(complete?" (complete)\n":" (partial)\n");
+}
+
+void TextResultWriter::end_command(){
+    out.put('\n');
+    out.flush();
+}
+
+void TextResultWriter::species(const string &name){
+    if(type!=tree_info_cmmd){
+        out.write(name).put('\n');
+        return;
+    }
+    if(!header_done){
+        out.write("The matching species are: \n");
+        header_done=true;
+    }
+    out.put('\t').write(name).put('\n');
+}
+
+void TextResultWriter::changed(int trees){
+    out.write("Trees changed: ", 15).write_int(trees).put('\n');
+}
+
+void TextResultWriter::no_matching_species(){
+    out.write("There are no matching species.\n");
+}
+
+void TextResultWriter::popularity(const string &region, int count, int total,
+                                  double percentage){
+    if(header_done){     //the species list is done; the table starts
+        out.write("Popularity in the city:\n");
+        header_done=false;
+    }
+    out.put('\t').write_left(region, 15).write_grouped_right(count, 12)
+       .write("  (", 3).write_grouped_right(total, 12).put(')')
+       .write_fixed_right(percentage, 2, 12).write("%\n", 2);
+}
+
+void TextResultWriter::frequency(const string &name, long count){
+    out.put('\t').write_left(name, 22).write_grouped_right(count, 8).put('\n');
+}
+
+void TextResultWriter::estimate(const string &name, long count, long error){
+    out.put('\t').write_left(name, 22).write_grouped_right(count, 8)
+       .write(" +/-", 4).write_grouped_right(error, 8).put('\n');
+}
+
+void TextResultWriter::memory(const string &structure, long items, long bytes,
+                              double per_tree){
+    if(!header_done){
+        out.put('\t').write_left("structure", 16).write_right("items", 5, 12)
+           .write_right("bytes", 5, 16).write_right("bytes/tree", 10, 12)
+           .put('\n');
+        header_done=true;
+    }
+    out.put('\t').write_left(structure, 16).write_grouped_right(items, 12)
+       .write_grouped_right(bytes, 16).write_fixed_right(per_tree, 1, 12)
+       .put('\n');
+}
+
+void TextResultWriter::cell(int x, int y, long count){
+    if(!header_done){
+        out.write("cell_x,cell_y,count\n", 20);
+        header_done=true;
+    }
+    out.write_int(x).put(',').write_int(y).put(',').write_int(count).put('\n');
+}
+
+void TextResultWriter::diversity(const Diversity &d){
+    if(!header_done){
+        out.write(d.by_cell?"cell_x,cell_y":"zipcode")
+           .write(",trees,species,shannon,simpson\n");
+        header_done=true;
+    }
+    if(d.by_cell)
+        out.write_int(d.x).put(',').write_int(d.y);
+    else
+        out.write_int(d.zipcode);
+    out.put(',').write_int(d.trees).put(',').write_int(d.species).put(',')
+       .write_fixed(d.shannon, 4).put(',').write_fixed(d.simpson, 4)
+       .put('\n');
+}
+
+void TextResultWriter::nearest(const NearestStats &stats){
+    const pair<const char *, double> distances[]={
+        {"mean (m)", stats.mean}, {"min (m)", stats.min},
+        {"10th pct (m)", stats.p10}, {"25th pct (m)", stats.p25},
+        {"median (m)", stats.median}, {"75th pct (m)", stats.p75},
+        {"90th pct (m)", stats.p90}, {"max (m)", stats.max}};
+    out.put('\t').write_left("trees", 16).write_grouped_right(stats.trees, 12)
+       .put('\n');
+    out.put('\t').write_left("with a neighbor", 16)
+       .write_grouped_right(stats.paired, 12).put('\n');
+    if(stats.paired==0)
+        return;
+    for(const auto &d:distances)
+        out.put('\t').write_left(d.first, 16)
+           .write_fixed_right(d.second, 1, 12).put('\n');
+}
+
+void TextResultWriter::tree(const Tree &t){
+    out<<t;
+    out.put('\n');
+}
+
+void TextResultWriter::no_such_tree(int id){
+    out.write("There is no tree with id ").write_int(id).write(".\n", 2);
+}
+
+void TextResultWriter::no_trees(){
+    out.write("Empty tree\n");
+}
+
+void TextResultWriter::flush(){
+    out.flush();
+}
+
+/****************************JsonlResultWriter Class***************************/
+
+JsonlResultWriter::JsonlResultWriter(ostream &_out, long _seq): out(_out),
+                                                               seq(_seq){}
+
+void JsonlResultWriter::begin_command(const Command &command){
+    string treename;
+    int zipcode, offset, limit, cell_m;
+    double latitude, longitude, distance, latitude2, longitude2;
+    bool result;
+    char buf[32];
+    string field, value;
+    
+    command.get_args(treename, zipcode, latitude, longitude, distance, result);
+    prefix="{\"seq\":"+to_string(seq++)+",\"command\":\"";
+    prefix+=command_name(command.type_of());
+    prefix+='"';
+    auto number=[&](const char *key, double value){
+        prefix+=",\"";
+        prefix+=key;
+        prefix+="\":";
+        prefix.append(buf, to_chars(buf, buf+sizeof(buf), value).ptr);
+    };
+    switch(command.type_of()){
+        case tree_info_cmmd:
+            prefix+=",\"query\":";
+            append_json_string(prefix, trim(treename));
+            break;
+        case listall_inzip_cmmd:prefix+=",\"zipcode\":"+to_string(zipcode);
+            break;
+        case list_near_cmmd:
+            number("latitude", latitude);
+            number("longitude", longitude);
+            number("distance", distance);
+            if(command.near_mode()!=exact_near){
+                prefix+=",\"mode\":\"";
+                prefix+=near_mode_name(command.near_mode());
+                prefix+='"';
+            }
+            break;
+        case list_in_box_cmmd:
+            command.get_box(latitude, longitude, latitude2, longitude2);
+            number("latitude1", latitude);
+            number("longitude1", longitude);
+            number("latitude2", latitude2);
+            number("longitude2", longitude2);
+            break;
+        case list_in_polygon_cmmd:
+            prefix+=",\"file\":";
+            append_json_string(prefix, command.polygon_file());
+            break;
+        case heatmap_cmmd:
+            command.get_heatmap(cell_m, treename);
+            prefix+=",\"cell_m\":"+to_string(cell_m);
+            if(!treename.empty()){
+                prefix+=",\"species\":";
+                append_json_string(prefix, treename);
+            }
+            break;
+        case diversity_cmmd:
+            command.get_diversity(cell_m);
+            if(cell_m==0)
+                prefix+=",\"by\":\"zip\"";
+            else
+                prefix+=",\"by\":\"grid\",\"cell_m\":"+to_string(cell_m);
+            break;
+        case nearest_same_species_cmmd:
+            prefix+=",\"species\":";
+            append_json_string(prefix, treename);
+            break;
+        case print_all_cmmd:
+            command.get_page(offset, limit);
+            if(limit>=0)
+                prefix+=",\"offset\":"+to_string(offset)+",\"limit\":"+
+                        to_string(limit);
+            break;
+        case tree_by_id_cmmd:
+        case delete_tree_cmmd:
+            prefix+=",\"id\":"+to_string(command.tree_id());
+            break;
+        case update_tree_cmmd:
+            command.get_change(field, value);
+            prefix+=",\"id\":"+to_string(command.tree_id())+",\"field\":";
+            append_json_string(prefix, field);
+            prefix+=",\"value\":";
+            append_json_string(prefix, value);
+            break;
+        case add_tree_cmmd:
+            command.get_change(field, value);
+            prefix+=",\"row\":";
+            append_json_string(prefix, value);
+            break;
+        default:break;
+    }
+}
+
+void JsonlResultWriter::coverage(long rows, bool complete){
+    prefix+=",\"rows\":"+to_string(rows)+",\"partial\":";
+    prefix+=complete?"false":"true";
+}
+
+void JsonlResultWriter::end_command(){
+    out.flush();
+}
+
+void JsonlResultWriter::species(const string &name){
+    out.write(prefix).write(",\"species\":");
+    string_value(name);
+    out.write("}\n", 2);
+}
+
+void JsonlResultWriter::changed(int trees){
+    out.write(prefix).write(",\"changed\":").write_int(trees).write("}\n", 2);
+}
+
+void JsonlResultWriter::no_matching_species(){}
+
+void JsonlResultWriter::popularity(const string &region, int count, int total,
+                                   double percentage){
+    out.write(prefix).write(",\"region\":");
+    string_value(region);
+    out.write(",\"count\":").write_int(count).write(",\"total\":")
+       .write_int(total).write(",\"percentage\":").write_double(percentage)
+       .write("}\n", 2);
+}
+
+void JsonlResultWriter::frequency(const string &name, long count){
+    out.write(prefix).write(",\"species\":");
+    string_value(name);
+    out.write(",\"count\":").write_int(count).write("}\n", 2);
+}
+
+void JsonlResultWriter::estimate(const string &name, long count, long error){
+    out.write(prefix).write(",\"species\":");
+    string_value(name);
+    out.write(",\"count\":").write_int(count).write(",\"error\":")
+       .write_int(error).write("}\n", 2);
+}
+
+void JsonlResultWriter::memory(const string &structure, long items,
+                               long bytes, double per_tree){
+    out.write(prefix).write(",\"structure\":");
+    string_value(structure);
+    out.write(",\"items\":").write_int(items).write(",\"bytes\":")
+       .write_int(bytes).write(",\"bytes_per_tree\":").write_double(per_tree)
+       .write("}\n", 2);
+}
+
+void JsonlResultWriter::cell(int x, int y, long count){
+    out.write(prefix).write(",\"cell_x\":").write_int(x).write(",\"cell_y\":")
+       .write_int(y).write(",\"count\":").write_int(count).write("}\n", 2);
+}
+
+void JsonlResultWriter::diversity(const Diversity &d){
+    out.write(prefix);
+    if(d.by_cell)
+        out.write(",\"cell_x\":").write_int(d.x).write(",\"cell_y\":")
+           .write_int(d.y);
+    else
+        out.write(",\"zipcode\":").write_int(d.zipcode);
+    out.write(",\"trees\":").write_int(d.trees).write(",\"species\":")
+       .write_int(d.species).write(",\"shannon\":").write_double(d.shannon)
+       .write(",\"simpson\":").write_double(d.simpson).write("}\n", 2);
+}
+
+void JsonlResultWriter::nearest(const NearestStats &stats){
+    out.write(prefix).write(",\"trees\":").write_int(stats.trees)
+       .write(",\"paired\":").write_int(stats.paired);
+    if(stats.paired>0)
+        out.write(",\"mean_m\":").write_double(stats.mean)
+           .write(",\"min_m\":").write_double(stats.min)
+           .write(",\"p10_m\":").write_double(stats.p10)
+           .write(",\"p25_m\":").write_double(stats.p25)
+           .write(",\"median_m\":").write_double(stats.median)
+           .write(",\"p75_m\":").write_double(stats.p75)
+           .write(",\"p90_m\":").write_double(stats.p90)
+           .write(",\"max_m\":").write_double(stats.max);
+    out.write("}\n", 2);
+}
+
+void JsonlResultWriter::tree(const Tree &t){
+    double latitude, longitude;
+    t.get_position(latitude, longitude);
+    out.write(prefix).write(",\"species\":");
+    string_value(t.common_name());
+    out.write(",\"tree_id\":").write_int(t.id())
+       .write(",\"dbh\":").write_int(t.diameter()).write(",\"status\":");
+    string_value(t.life_status());
+    out.write(",\"health\":");
+    string_value(t.tree_health());
+    out.write(",\"zipcode\":").write_int(t.zip_code()).write(",\"address\":");
+    string_value(t.nearest_address());
+    out.write(",\"borough\":");
+    string_value(t.borough_name());
+    out.write(",\"latitude\":").write_double(latitude)
+       .write(",\"longitude\":").write_double(longitude).write("}\n", 2);
+}
+
+void JsonlResultWriter::no_such_tree(int){}
+
+void JsonlResultWriter::no_trees(){}
+
+void JsonlResultWriter::flush(){
+    out.flush();
+}
+
+//writes s as a JSON string literal
+void JsonlResultWriter::string_value(const string &s){
+    scratch.clear();
+    append_json_string(scratch, s);
+    out.write(scratch);
+}
+
+/****************************CsvResultWriter Class*****************************/
+
+CsvResultWriter::CsvResultWriter(ostream &_out, long _seq): out(_out),
+                                                           seq(_seq){}
+
+void CsvResultWriter::begin_command(const Command &command){
+    prefix=to_string(seq++)+","+command_name(command.type_of())+",";
+}
+
+void CsvResultWriter::coverage(long rows, bool complete){
+    out.write(prefix).write("coverage,", 9).write_int(rows)
+       .write(complete?",complete\n":",partial\n");
+}
+
+void CsvResultWriter::end_command(){
+    out.flush();
+}
+
+void CsvResultWriter::species(const string &name){
+    out.write(prefix).write("species,", 8);
+    field(name);
+    out.put('\n');
+}
+
+void CsvResultWriter::changed(int trees){
+    out.write(prefix).write("changed,", 8).write_int(trees).put('\n');
+}
+
+void CsvResultWriter::no_matching_species(){}
+
+void CsvResultWriter::popularity(const string &region, int count, int total,
+                                 double percentage){
+    out.write(prefix).write("popularity,", 11);
+    field(region);
+    out.put(',').write_int(count).put(',').write_int(total).put(',')
+       .write_double(percentage).put('\n');
+}
+
+void CsvResultWriter::frequency(const string &name, long count){
+    out.write(prefix).write("frequency,", 10);
+    field(name);
+    out.put(',').write_int(count).put('\n');
+}
+
+void CsvResultWriter::estimate(const string &name, long count, long error){
+    out.write(prefix).write("estimate,", 9);
+    field(name);
+    out.put(',').write_int(count).put(',').write_int(error).put('\n');
+}
+
+void CsvResultWriter::memory(const string &structure, long items, long bytes,
+                             double per_tree){
+    out.write(prefix).write("memory,", 7);
+    field(structure);
+    out.put(',').write_int(items).put(',').write_int(bytes).put(',')
+       .write_double(per_tree).put('\n');
+}
+
+void CsvResultWriter::cell(int x, int y, long count){
+    out.write(prefix).write("cell,", 5).write_int(x).put(',').write_int(y)
+       .put(',').write_int(count).put('\n');
+}
+
+void CsvResultWriter::diversity(const Diversity &d){
+    out.write(prefix);
+    if(d.by_cell)
+        out.write("cell_diversity,", 15).write_int(d.x).put(',')
+           .write_int(d.y);
+    else
+        out.write("zip_diversity,", 14).write_int(d.zipcode);
+    out.put(',').write_int(d.trees).put(',').write_int(d.species).put(',')
+       .write_double(d.shannon).put(',').write_double(d.simpson).put('\n');
+}
+
+void CsvResultWriter::nearest(const NearestStats &stats){
+    out.write(prefix).write("nearest,", 8).write_int(stats.trees).put(',')
+       .write_int(stats.paired);
+    //the distances are left empty for a species without pairs
+    for(double d:{stats.mean, stats.min, stats.p10, stats.p25, stats.median,
+                  stats.p75, stats.p90, stats.max}){
+        out.put(',');
+        if(stats.paired>0)
+            out.write_double(d);
+    }
+    out.put('\n');
+}
+
+void CsvResultWriter::tree(const Tree &t){
+    double latitude, longitude;
+    t.get_position(latitude, longitude);
+    out.write(prefix).write("tree,", 5);
+    field(t.common_name());
+    out.put(',').write_int(t.id()).put(',').write_int(t.diameter()).put(',');
+    field(t.life_status());
+    out.put(',');
+    field(t.tree_health());
+    out.put(',').write_int(t.zip_code()).put(',');
+    field(t.nearest_address());
+    out.put(',');
+    field(t.borough_name());
+    out.put(',').write_double(latitude).put(',').write_double(longitude)
+       .put('\n');
+}
+
+void CsvResultWriter::no_such_tree(int){}
+
+void CsvResultWriter::no_trees(){}
+
+void CsvResultWriter::flush(){
+    out.flush();
+}
+
+//writes s, quoted if it holds a comma, a quote or a line break
+void CsvResultWriter::field(const string &s){
+    if(s.find_first_of(",\"\r\n")==string::npos){
+        out.write(s);
+        return;
+    }
+    out.put('"');
+    for(char c:s){
+        if(c=='"') out.put('"');
+        out.put(c);
+    }
+    out.put('"');
+}
+
+/****************************CountingResultWriter Class************************/
+
+CountingResultWriter::CountingResultWriter(__ResultWriter &_out): out(_out),
+                                           count(0){}
+
+void CountingResultWriter::begin_command(const Command &command){
+    out.begin_command(command);
+}
+
+void CountingResultWriter::coverage(long rows, bool complete){
+    out.coverage(rows, complete);
+}
+
+void CountingResultWriter::end_command(){
+    out.end_command();
+}
+
+void CountingResultWriter::species(const string &name){
+    count++;
+    out.species(name);
+}
+
+void CountingResultWriter::changed(int trees){
+    count++;
+    out.changed(trees);
+}
+
+void CountingResultWriter::no_matching_species(){
+    out.no_matching_species();
+}
+
+void CountingResultWriter::popularity(const string &region, int n, int total,
+                                      double percentage){
+    count++;
+    out.popularity(region, n, total, percentage);
+}
+
+void CountingResultWriter::frequency(const string &name, long n){
+    count++;
+    out.frequency(name, n);
+}
+
+void CountingResultWriter::estimate(const string &name, long n, long error){
+    count++;
+    out.estimate(name, n, error);
+}
+
+void CountingResultWriter::memory(const string &structure, long items,
+                                  long bytes, double per_tree){
+    count++;
+    out.memory(structure, items, bytes, per_tree);
+}
+
+void CountingResultWriter::cell(int x, int y, long n){
+    count++;
+    out.cell(x, y, n);
+}
+
+void CountingResultWriter::diversity(const Diversity &d){
+    count++;
+    out.diversity(d);
+}
+
+void CountingResultWriter::nearest(const NearestStats &stats){
+    count++;
+    out.nearest(stats);
+}
+
+void CountingResultWriter::tree(const Tree &t){
+    count++;
+    out.tree(t);
+}
+
+void CountingResultWriter::no_such_tree(int id){
+    out.no_such_tree(id);
+}
+
+void CountingResultWriter::no_trees(){
+    out.no_trees();
+}
+
+void CountingResultWriter::flush(){
+    out.flush();
+}
+
+long CountingResultWriter::rows() const{
+    return count;
+}
@@ -0,0 +1,253 @@
+/*******************************************************************************
+Title           : result_writer.h
+Created on      : Oct 19, 2026
+Description     : The text, JSON Lines and CSV implementations of
+                  __ResultWriter
+*******************************************************************************/
+
+#ifndef SW2_RESULT_WRITER_H_
+#define SW2_RESULT_WRITER_H_
+
+#include "__result_writer.h"
+#include "../Output/buffered_writer.h"
+
+/** class TextResultWriter writes the tables people read. Its output is the
+ *  one the program has always printed, byte for byte.
+ */
+class TextResultWriter: public __ResultWriter{
+    public:
+    
+    explicit TextResultWriter(ostream &out);
+    
+    void begin_command(const Command &command) override;
+    
+    void coverage(long rows, bool complete) override;
+    
+    void end_command() override;
+    
+    void species(const string &name) override;
+    
+    void changed(int trees) override;
+    
+    void no_matching_species() override;
+    
+    void popularity(const string &region, int count, int total,
+                    double percentage) override;
+    
+    void frequency(const string &name, long count) override;
+    
+    void estimate(const string &name, long count, long error) override;
+    
+    void memory(const string &structure, long items, long bytes,
+                double per_tree) override;
+    
+    void cell(int x, int y, long count) override;
+    
+    void diversity(const Diversity &d) override;
+    
+    void nearest(const NearestStats &stats) override;
+    
+    void tree(const Tree &t) override;
+    
+    void no_such_tree(int id) override;
+    
+    void no_trees() override;
+    
+    void flush() override;
+    
+    private:
+    
+    BufferedWriter out;
+    Command_type type;
+    bool header_done;
+};
+
+/** class JsonlResultWriter writes one compact JSON object per row. Every
+ *  object has "seq", the number of commands that were run before this one,
+ *  and "command", its name, followed by the command's arguments and the
+ *  row's own fields. Commands without rows write nothing.
+ */
+class JsonlResultWriter: public __ResultWriter{
+    public:
+    
+    /** JsonlResultWriter(out,seq) numbers the first command seq */
+    explicit JsonlResultWriter(ostream &out, long seq=0);
+    
+    void begin_command(const Command &command) override;
+    
+    void coverage(long rows, bool complete) override;
+    
+    void end_command() override;
+    
+    void species(const string &name) override;
+    
+    void changed(int trees) override;
+    
+    void no_matching_species() override;
+    
+    void popularity(const string &region, int count, int total,
+                    double percentage) override;
+    
+    void frequency(const string &name, long count) override;
+    
+    void estimate(const string &name, long count, long error) override;
+    
+    void memory(const string &structure, long items, long bytes,
+                double per_tree) override;
+    
+    void cell(int x, int y, long count) override;
+    
+    void diversity(const Diversity &d) override;
+    
+    void nearest(const NearestStats &stats) override;
+    
+    void tree(const Tree &t) override;
+    
+    void no_such_tree(int id) override;
+    
+    void no_trees() override;
+    
+    void flush() override;
+    
+    private:
+    
+    BufferedWriter out;
+    long seq;
+    string prefix;      // '{' up to the last argument of the command
+    string scratch;
+    
+    void string_value(const string &s);
+};
+
+/** class CsvResultWriter writes one RFC 4180 line per row, with no header:
+ *      seq,command,kind,<fields of the kind>
+ *  where kind and its fields are one of
+ *      species,name
+ *      popularity,region,count,total,percentage
+ *      frequency,name,count
+ *      estimate,name,count,error
+ *      memory,structure,items,bytes,per_tree
+ *      cell,x,y,count
+ *      zip_diversity,zipcode,trees,species,shannon,simpson
+ *      cell_diversity,x,y,trees,species,shannon,simpson
+ *      nearest,trees,paired,mean,min,p10,p25,median,p75,p90,max
+ *      tree,<the ten fields in print_all order>
+ *  Commands without rows write nothing.
+ */
+class CsvResultWriter: public __ResultWriter{
+    public:
+    
+    /** CsvResultWriter(out,seq) numbers the first command seq */
+    explicit CsvResultWriter(ostream &out, long seq=0);
+    
+    void begin_command(const Command &command) override;
+    
+    void coverage(long rows, bool complete) override;
+    
+    void end_command() override;
+    
+    void species(const string &name) override;
+    
+    void changed(int trees) override;
+    
+    void no_matching_species() override;
+    
+    void popularity(const string &region, int count, int total,
+                    double percentage) override;
+    
+    void frequency(const string &name, long count) override;
+    
+    void estimate(const string &name, long count, long error) override;
+    
+    void memory(const string &structure, long items, long bytes,
+                double per_tree) override;
+    
+    void cell(int x, int y, long count) override;
+    
+    void diversity(const Diversity &d) override;
+    
+    void nearest(const NearestStats &stats) override;
+    
+    void tree(const Tree &t) override;
+    
+    void no_such_tree(int id) override;
+    
+    void no_trees() override;
+    
+    void flush() override;
+    
+    private:
+    
+    BufferedWriter out;
+    long seq;
+    string prefix;      // "seq,command,"
+    
+    void field(const string &s);
+};
+
+/** class CountingResultWriter passes everything on to another writer and
+ *  counts the result rows: species, popularity, frequency, estimate,
+ *  memory, cell, diversity, nearest, tree and changed rows, not the
+ *  messages for missing results.
+ */
+class CountingResultWriter: public __ResultWriter{
+    public:
+    
+    explicit CountingResultWriter(__ResultWriter &out);
+    
+    void begin_command(const Command &command) override;
+    
+    void coverage(long rows, bool complete) override;
+    
+    void end_command() override;
+    
+    void species(const string &name) override;
+    
+    void changed(int trees) override;
+    
+    void no_matching_species() override;
+    
+    void popularity(const string &region, int count, int total,
+                    double percentage) override;
+    
+    void frequency(const string &name, long count) override;
+    
+    void estimate(const string &name, long count, long error) override;
+    
+    void memory(const string &structure, long items, long bytes,
+                double per_tree) override;
+    
+    void cell(int x, int y, long count) override;
+    
+    void diversity(const Diversity &d) override;
+    
+    void nearest(const NearestStats &stats) override;
+    
+    void tree(const Tree &t) override;
+    
+    void no_such_tree(int id) override;
+    
+    void no_trees() override;
+    
+    void flush() override;
+    
+    /** rows() returns the number of result rows passed on so far */
+    long rows() const;
+    
+    private:
+    
+    __ResultWriter &out;
+    long count;
+};
+
+/** make_result_writer(f,out,seq) returns a new writer of format f on out.
+ *  Formats that number the commands start with seq.
+ */
+unique_ptr<__ResultWriter> make_result_writer(Output_format format,
+                                              ostream &out, long seq=0);
+
+/** command_name(t) returns the name commands of type t have in command files
+ */
+const char *command_name(Command_type type);
+
+#endif //SW2_RESULT_WRITER_H_
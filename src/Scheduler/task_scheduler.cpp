@@ -0,0 +1,187 @@
+/**
+    task_scheduler.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement task_scheduler and task_group classes
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "task_scheduler.h"
+
+//index of the calling thread's queue in the scheduler it works for
+thread_local TaskScheduler *current_scheduler=nullptr;
+thread_local size_t current_index=0;
+
+//scheduler installed by the innermost SchedulerScope of the calling thread
+thread_local TaskScheduler *scoped_scheduler=nullptr;
+
+atomic<size_t> default_threads(0);
+
+/****************************TaskScheduler Class*******************************/
+
+TaskScheduler::TaskScheduler(size_t threads): queued(0), next_queue(0),
+                                              stopping(false){
+    if(threads==0)
+        threads=max(1u, thread::hardware_concurrency());
+    for(size_t i=0; i<threads; i++)
+        queues.push_back(make_unique<WorkQueue>());
+    for(size_t i=0; i<threads; i++)
+        workers.emplace_back(&TaskScheduler::work, this, i);
+}
+
+TaskScheduler::~TaskScheduler(){
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        stopping=true;
+    }
+    wake.notify_all();
+    for(auto &worker:workers)
+        worker.join();
+}
+
+void TaskScheduler::submit(function<void()> task){
+    //a worker keeps what it spawns; other threads deal tasks out in turn
+    size_t index=current_scheduler==this?current_index:
+                 next_queue++%queues.size();
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+bool TaskScheduler::run_one(){
+    function<void()> task;
+    size_t index=current_scheduler==this?current_index:
+                 next_queue%queues.size();
+    if(!take(index, task))
+        return false;
+    task();
+    return true;
+}
+
+size_t TaskScheduler::size() const{
+    return workers.size();
+}
+
+TaskScheduler &TaskScheduler::instance(){
+    static TaskScheduler scheduler(default_threads);
+    return scheduler;
+}
+
+TaskScheduler &TaskScheduler::current(){
+    if(current_scheduler)
+        return *current_scheduler;
+    if(scoped_scheduler)
+        return *scoped_scheduler;
+    return instance();
+}
+
+void TaskScheduler::set_default_threads(size_t threads){
+    default_threads=threads;
+}
+
+//runs tasks until the scheduler is stopping and every queue is empty
+void TaskScheduler::work(size_t index){
+    current_scheduler=this;
+    current_index=index;
+    function<void()> task;
+    while(true){
+        if(take(index, task)){
+            task();
+            task=nullptr;
+            continue;
+        }
+        unique_lock<mutex> guard(sleep_lock);
+        if(stopping && queued==0)
+            return;
+        wake.wait(guard, [this]{ return stopping || queued>0; });
+    }
+}
+
+//pops the newest task of queue index, or else steals the oldest task of
+//another queue
+bool TaskScheduler::take(size_t index, function<void()> &task){
+    size_t n=queues.size();
+    for(size_t k=0; k<n; k++){
+        WorkQueue &q=*queues[(index+k)%n];
+        lock_guard<mutex> guard(q.lock);
+        if(q.tasks.empty())
+            continue;
+        if(k==0){
+            task=move(q.tasks.back());
+            q.tasks.pop_back();
+        }
+        else{
+            task=move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+/****************************SchedulerScope Class******************************/
+
+SchedulerScope::SchedulerScope(TaskScheduler &scheduler):
+                               previous(scoped_scheduler){
+    scoped_scheduler=&scheduler;
+}
+
+SchedulerScope::~SchedulerScope(){
+    scoped_scheduler=previous;
+}
+
+/****************************TaskGroup Class***********************************/
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler): owner(scheduler), pending(0){}
+
+TaskGroup::~TaskGroup(){
+    try{
+        wait();
+    }
+    catch(...){}
+}
+
+void TaskGroup::run(function<void()> f){
+    pending++;
+    owner.submit([this, f]{
+        try{
+            f();
+        }
+        catch(...){
+            lock_guard<mutex> guard(error_lock);
+            if(!error) error=current_exception();
+        }
+        pending--;
+    });
+}
+
+void TaskGroup::wait(){
+    while(pending>0)
+        if(!owner.run_one())
+            this_thread::yield();
+    if(error){
+        exception_ptr e=error;
+        error=nullptr;
+        rethrow_exception(e);
+    }
+}
+
+TaskScheduler &TaskGroup::scheduler() const{
+    return owner;
+}
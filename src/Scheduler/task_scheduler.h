@@ -0,0 +1,208 @@
+/*******************************************************************************
+Title           : task_scheduler.h
+Created on      : Oct 19, 2026
+Description     : Interface of the TaskScheduler and TaskGroup classes and of
+                  the parallel algorithms built on them
+Purpose         : One set of worker threads shared by loading, index building
+                  and query scans, instead of each starting its own threads
+*******************************************************************************/
+
+#ifndef SW2_TASK_SCHEDULER_H_
+#define SW2_TASK_SCHEDULER_H_
+
+using namespace std;
+
+/** class TaskScheduler is a work-stealing scheduler. Every worker has its
+ *  own deque of tasks: it pushes and pops the tasks it spawns at the back,
+ *  so it keeps working on what is hot in its cache, and idle workers steal
+ *  from the front of the other deques, where the biggest pieces of work are.
+ *  Threads that are not workers add their tasks to the workers' deques in
+ *  turn.
+ *  A thread that waits for tasks (see TaskGroup::wait) runs queued tasks
+ *  while it waits, so nested fork/join never runs out of threads.
+ */
+class TaskScheduler{
+    public:
+    
+    /** TaskScheduler(n) starts n workers, or one per hardware thread if n is
+     *  0. With one worker, the parallel algorithms below run serially.
+     */
+    explicit TaskScheduler(size_t threads=0);
+    
+    TaskScheduler(const TaskScheduler &)=delete;
+    
+    TaskScheduler &operator =(const TaskScheduler &)=delete;
+    
+    /** ~TaskScheduler() finishes the queued tasks and joins the workers */
+    ~TaskScheduler();
+    
+    /** submit(task) queues task */
+    void submit(function<void()> task);
+    
+    /** run_one() runs one queued task on the calling thread, if there is one
+     *  @return bool true if a task was run
+     */
+    bool run_one();
+    
+    /** size() returns the number of workers */
+    size_t size() const;
+    
+    /** instance() returns the scheduler shared by the whole program. It is
+     *  started on first use, with the number of workers last given to
+     *  set_default_threads(), or one per hardware thread.
+     */
+    static TaskScheduler &instance();
+    
+    /** current() returns the scheduler the calling thread works for, else
+     *  the one installed by the innermost SchedulerScope of the thread, else
+     *  instance(). The parallel algorithms use it by default, so nested
+     *  tasks stay on the scheduler that runs them.
+     */
+    static TaskScheduler &current();
+    
+    /** set_default_threads(n) sets the size of instance(); it has no effect
+     *  once instance() has been called
+     */
+    static void set_default_threads(size_t threads);
+    
+    private:
+    
+    struct WorkQueue{
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+    
+    vector<unique_ptr<WorkQueue>> queues;
+    vector<thread> workers;
+    atomic<long> queued;
+    atomic<size_t> next_queue;
+    atomic<bool> stopping;
+    mutex sleep_lock;
+    condition_variable wake;
+    
+    void work(size_t index);
+    
+    bool take(size_t index, function<void()> &task);
+};
+
+/** class SchedulerScope makes a scheduler the current() one of the calling
+ *  thread for its lifetime, e.g. to time the same work on several thread
+ *  counts
+ */
+class SchedulerScope{
+    public:
+    
+    explicit SchedulerScope(TaskScheduler &scheduler);
+    
+    SchedulerScope(const SchedulerScope &)=delete;
+    
+    SchedulerScope &operator =(const SchedulerScope &)=delete;
+    
+    ~SchedulerScope();
+    
+    private:
+    
+    TaskScheduler *previous;
+};
+
+/** class TaskGroup runs a set of tasks on a TaskScheduler and waits for all
+ *  of them. The first exception thrown by a task is rethrown by wait().
+ */
+class TaskGroup{
+    public:
+    
+    explicit TaskGroup(TaskScheduler &scheduler=TaskScheduler::current());
+    
+    TaskGroup(const TaskGroup &)=delete;
+    
+    TaskGroup &operator =(const TaskGroup &)=delete;
+    
+    ~TaskGroup();
+    
+    /** run(f) starts f() as a task of this group */
+    void run(function<void()> f);
+    
+    /** wait() returns when every task of the group is done, running queued
+     *  tasks in the meantime
+     */
+    void wait();
+    
+    TaskScheduler &scheduler() const;
+    
+    private:
+    
+    TaskScheduler &owner;
+    atomic<long> pending;
+    mutex error_lock;
+    exception_ptr error;
+};
+
+/** parallel_invoke(f,g) runs f() and g() in parallel and returns when both
+ *  are done
+ */
+template <class F, class G>
+    void parallel_invoke(F f, G g,
+                         TaskScheduler &scheduler=TaskScheduler::current()){
+        if(scheduler.size()<=1){
+            f();
+            g();
+            return;
+        }
+        TaskGroup group(scheduler);
+        group.run(f);
+        g();
+        group.wait();
+    }
+
+/** parallel_for(begin,end,grain,f) calls f(lo,hi) on disjoint ranges that
+ *  cover [begin,end). Ranges are split in halves until they hold at most
+ *  grain items, so idle workers steal the large halves first.
+ */
+template <class F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F f,
+                      TaskScheduler &scheduler=TaskScheduler::current()){
+        if(end<=begin)
+            return;
+        if(end-begin<=max(grain, size_t(1)) || scheduler.size()<=1){
+            f(begin, end);
+            return;
+        }
+        size_t middle=begin+(end-begin)/2;
+        parallel_invoke([=, &scheduler]{
+                            parallel_for(begin, middle, grain, f, scheduler);
+                        },
+                        [=, &scheduler]{
+                            parallel_for(middle, end, grain, f, scheduler);
+                        },
+                        scheduler);
+    }
+
+/** parallel_reduce(begin,end,grain,identity,map,combine) returns the
+ *  combination of map(lo,hi) over ranges that cover [begin,end), in order,
+ *  starting from identity. combine must be associative.
+ */
+template <class T, class Map, class Combine>
+    T parallel_reduce(size_t begin, size_t end, size_t grain, T identity,
+                      Map map, Combine combine,
+                      TaskScheduler &scheduler=TaskScheduler::current()){
+        if(end<=begin)
+            return identity;
+        if(end-begin<=max(grain, size_t(1)) || scheduler.size()<=1)
+            return combine(identity, map(begin, end));
+        size_t middle=begin+(end-begin)/2;
+        T left=identity, right=identity;
+        parallel_invoke([&]{
+                            left=parallel_reduce(begin, middle, grain,
+                                                 identity, map, combine,
+                                                 scheduler);
+                        },
+                        [&]{
+                            right=parallel_reduce(middle, end, grain,
+                                                  identity, map, combine,
+                                                  scheduler);
+                        },
+                        scheduler);
+        return combine(left, right);
+    }
+
+#endif //SW2_TASK_SCHEDULER_H_
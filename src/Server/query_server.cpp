@@ -0,0 +1,214 @@
+/**
+    query_server.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement query_server class and the client for it
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "query_server.h"
+#include "../Command/command.h"
+#include "../Executor/command_executor.h"
+#include "../ResultWriter/result_writer.h"
+#include "../ThreadPool/thread_pool.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const int POLL_INTERVAL_MS=200;     // how often blocked loops check stopping
+const size_t READ_SIZE=64*1024;
+
+//set by the signal handler and read by the pool's threads, so it has to be
+//atomic, and lock-free to be safe to set in a handler
+static_assert(atomic<bool>::is_always_lock_free,
+              "stopping must be lock-free to be set in a signal handler");
+atomic<bool> stopping(false);
+
+/****************************Helper Functions**********************************/
+
+void on_stop_signal(int){
+    stopping=true;
+}
+
+//fills addr with path; returns false if path does not fit
+bool socket_address(const string &path, sockaddr_un &addr){
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family=AF_UNIX;
+    if(path.size()>=sizeof(addr.sun_path)){
+        cerr<<"Socket path "<<path<<" is too long"<<endl;
+        return false;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+//sends all of data; returns false if the peer went away
+bool send_all(int fd, const string &data){
+    size_t sent=0;
+    while(sent<data.size()){
+        ssize_t n=send(fd, data.data()+sent, data.size()-sent, MSG_NOSIGNAL);
+        if(n<0 && errno==EINTR) continue;
+        if(n<=0) return false;
+        sent+=n;
+    }
+    return true;
+}
+
+/****************************QueryServer Class*********************************/
+
+QueryServer::QueryServer(TreeCollection &_trees, Output_format _format,
+                         size_t _threads): trees(_trees), format(_format),
+                                           threads(_threads){}
+
+bool QueryServer::serve(const string &path){
+    sockaddr_un addr;
+    if(!socket_address(path, addr))
+        return false;
+    
+    int listener=socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener<0){
+        cerr<<"Could not create socket: "<<strerror(errno)<<endl;
+        return false;
+    }
+    unlink(path.c_str());           //left behind by a server that crashed
+    if(bind(listener, (sockaddr *) &addr, sizeof(addr))<0 ||
+       listen(listener, SOMAXCONN)<0){
+        cerr<<"Could not listen on "<<path<<": "<<strerror(errno)<<endl;
+        close(listener);
+        return false;
+    }
+    
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler=on_stop_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    stopping=false;
+    
+    ThreadPool pool(threads);
+    cerr<<"Serving on "<<path<<" with "<<pool.size()<<" threads"<<endl;
+    while(!stopping){
+        pollfd p={listener, POLLIN, 0};
+        if(poll(&p, 1, POLL_INTERVAL_MS)<=0)
+            continue;
+        int client=accept(listener, nullptr, nullptr);
+        if(client<0)
+            continue;
+        pool.submit([this, client]{ serve_client(client); });
+    }
+    
+    close(listener);
+    pool.shutdown();
+    unlink(path.c_str());
+    cerr<<"Server stopped"<<endl;
+    return true;
+}
+
+void QueryServer::stop(){
+    stopping=true;
+}
+
+//answers the lines sent on fd until the client closes its side or the server
+//is stopping, then closes fd
+void QueryServer::serve_client(int fd){
+    CommandExecutor executor(trees);
+    ostringstream answer;
+    unique_ptr<__ResultWriter> writer=make_result_writer(format, answer);
+    string pending;
+    char buf[READ_SIZE];
+    bool connected=true;
+    
+    auto run=[&](const string &line){
+        istringstream in(line+"\n");
+        Command command;
+        if(!command.get_next(in)){
+            cerr<<"Error getting command.\n";
+            return true;
+        }
+        executor.execute(command, *writer);
+        writer->flush();
+        bool sent=send_all(fd, answer.str());
+        answer.str("");
+        return sent;
+    };
+    
+    while(connected && !stopping){
+        pollfd p={fd, POLLIN, 0};
+        int ready=poll(&p, 1, POLL_INTERVAL_MS);
+        if(ready<0 && errno!=EINTR) break;
+        if(ready<=0) continue;
+        
+        ssize_t n=read(fd, buf, sizeof(buf));
+        if(n<0 && errno==EINTR) continue;
+        if(n<=0){
+            //the client is done; a last line without '\n' is still a command
+            if(!pending.empty()) run(pending);
+            break;
+        }
+        pending.append(buf, n);
+        size_t start=0, end;
+        while(connected && (end=pending.find('\n', start))!=string::npos){
+            connected=run(pending.substr(start, end-start));
+            start=end+1;
+        }
+        pending.erase(0, start);
+    }
+    close(fd);
+}
+
+/****************************Client********************************************/
+
+bool run_client(const string &path, istream &commands, ostream &out){
+    sockaddr_un addr;
+    if(!socket_address(path, addr))
+        return false;
+    int fd=socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd<0 || connect(fd, (sockaddr *) &addr, sizeof(addr))<0){
+        cerr<<"Could not connect to "<<path<<": "<<strerror(errno)<<endl;
+        if(fd>=0) close(fd);
+        return false;
+    }
+    
+    string request((istreambuf_iterator<char>(commands)),
+                   istreambuf_iterator<char>());
+    size_t sent=0;
+    char buf[READ_SIZE];
+    
+    //send and receive at the same time, so that neither side can block on a
+    //full socket buffer while the other one is also writing
+    if(request.empty()) shutdown(fd, SHUT_WR);
+    while(true){
+        pollfd p={fd, short(POLLIN|(sent<request.size()?POLLOUT:0)), 0};
+        if(poll(&p, 1, -1)<0){
+            if(errno==EINTR) continue;
+            break;
+        }
+        if(p.revents & POLLOUT){
+            ssize_t n=send(fd, request.data()+sent, request.size()-sent,
+                           MSG_NOSIGNAL);
+            if(n>0 && (sent+=n)==request.size())
+                shutdown(fd, SHUT_WR);
+        }
+        if(p.revents & (POLLIN|POLLHUP|POLLERR)){
+            ssize_t n=read(fd, buf, sizeof(buf));
+            if(n<0 && errno==EINTR) continue;
+            if(n<=0) break;
+            out.write(buf, n);
+        }
+    }
+    close(fd);
+    out.flush();
+    return true;
+}
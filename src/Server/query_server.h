@@ -0,0 +1,63 @@
+/*******************************************************************************
+Title           : query_server.h
+Created on      : Oct 19, 2026
+Description     : Interface of the QueryServer class and of the client that
+                  talks to it
+Purpose         : Loads the tree data once and answers command lines sent
+                  over a Unix domain socket, so that a lookup does not pay
+                  for reading the whole census file
+*******************************************************************************/
+
+#ifndef SW2_QUERY_SERVER_H_
+#define SW2_QUERY_SERVER_H_
+
+#include "../TreeCollection/tree_collection.h"
+#include "../ResultWriter/__result_writer.h"
+
+using namespace std;
+
+/** class QueryServer listens on a Unix domain socket. A client sends command
+ *  lines in the grammar of command files and may close its writing side when
+ *  it is done; the server answers each line as soon as it has been read, in
+ *  the server's output format, and closes the connection after the last
+ *  answer. Connections are served by a pool of threads that share the
+ *  collection, which must not change while the server runs.
+ *  SIGINT and SIGTERM stop the server: it stops accepting connections,
+ *  finishes the command lines it has already read, and removes the socket.
+ */
+class QueryServer{
+    public:
+    
+    /** QueryServer(trees,format,threads) serves trees with threads workers,
+     *  or one per hardware thread if threads is 0
+     */
+    QueryServer(TreeCollection &trees, Output_format format, size_t threads);
+    
+    /** serve(path) binds path and serves clients until stopped
+     *  @return bool false, after printing the reason on cerr, if the socket
+     *               could not be set up
+     */
+    bool serve(const string &path);
+    
+    /** stop() makes serve() return once the connections in progress end.
+     *  It is safe to call from a signal handler or another thread.
+     */
+    static void stop();
+    
+    private:
+    
+    TreeCollection &trees;
+    Output_format format;
+    size_t threads;
+    
+    void serve_client(int fd);
+};
+
+/** run_client(path,commands,out) sends every line of commands to the server
+ *  at path and copies the answers to out
+ *  @return bool false, after printing the reason on cerr, if the server
+ *               could not be reached
+ */
+bool run_client(const string &path, istream &commands, ostream &out);
+
+#endif //SW2_QUERY_SERVER_H_
@@ -0,0 +1,48 @@
+/*******************************************************************************
+Title           : snapshot_slot.h
+Created on      : Oct 19, 2026
+Description     : Interface and implementation of the SnapshotSlot template
+Purpose         : Hands the snapshots made by a writer thread to reader
+                  threads without making either wait for the other's work
+*******************************************************************************/
+
+#ifndef SW2_SNAPSHOT_SLOT_H_
+#define SW2_SNAPSHOT_SLOT_H_
+
+using namespace std;
+
+/** class SnapshotSlot holds the latest snapshot of a T that a writer
+ *  published. Readers take a reference to it, which keeps it alive for as
+ *  long as they use it, even after the writer has published newer ones.
+ *  The slot itself is only locked for the few instructions it takes to copy
+ *  the pointer, never while the writer builds a snapshot or a reader uses one.
+ */
+template <class T>
+    class SnapshotSlot{
+        public:
+        
+        SnapshotSlot()=default;
+        
+        SnapshotSlot(const SnapshotSlot &)=delete;
+        
+        SnapshotSlot &operator =(const SnapshotSlot &)=delete;
+        
+        /** publish(snapshot) replaces the snapshot readers get */
+        void publish(shared_ptr<const T> snapshot){
+            atomic_store_explicit(&latest, move(snapshot),
+                                  memory_order_release);
+        }
+        
+        /** acquire() returns the latest published snapshot, or nullptr if
+         *  nothing was published yet
+         */
+        shared_ptr<const T> acquire() const{
+            return atomic_load_explicit(&latest, memory_order_acquire);
+        }
+        
+        private:
+        
+        shared_ptr<const T> latest;
+    };
+
+#endif //SW2_SNAPSHOT_SLOT_H_
@@ -0,0 +1,80 @@
+/**
+    latency_histogram.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement latency_histogram class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "latency_histogram.h"
+
+/****************************LatencyHistogram Class****************************/
+
+LatencyHistogram::LatencyHistogram(): total(0), sum(0), largest(0){
+    for(auto &b:buckets)
+        b.store(0, memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint64_t value){
+    buckets[bucket_of(value)].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(value, memory_order_relaxed);
+    uint64_t seen=largest.load(memory_order_relaxed);
+    while(value>seen &&
+          !largest.compare_exchange_weak(seen, value, memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::count() const{
+    return total.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const{
+    return largest.load(memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const{
+    uint64_t n=count();
+    return n==0?0:(double)sum.load(memory_order_relaxed)/n;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const{
+    uint64_t n=count();
+    if(n==0)
+        return 0;
+    uint64_t rank=std::max(uint64_t(1), (uint64_t)ceil(p*n));
+    uint64_t seen=0;
+    for(int b=0; b<NUM_BUCKETS; b++){
+        seen+=buckets[b].load(memory_order_relaxed);
+        if(seen>=rank)
+            return min(bucket_top(b), max());
+    }
+    return max();
+}
+
+//values below SUB_BUCKETS have a bucket each; above, the top
+//SUB_BUCKET_BITS+1 bits of the value pick the bucket within its power of two
+int LatencyHistogram::bucket_of(uint64_t value){
+    if(value<(uint64_t)SUB_BUCKETS)
+        return value;
+    int magnitude=63-__builtin_clzll(value);
+    int shift=magnitude-SUB_BUCKET_BITS;
+    return (shift+1)*SUB_BUCKETS+(int)(value>>shift)-SUB_BUCKETS;
+}
+
+//the largest value that falls into bucket
+uint64_t LatencyHistogram::bucket_top(int bucket){
+    if(bucket<SUB_BUCKETS)
+        return bucket;
+    int shift=bucket/SUB_BUCKETS-1;
+    uint64_t top=SUB_BUCKETS+bucket%SUB_BUCKETS;
+    return ((top+1)<<shift)-1;
+}
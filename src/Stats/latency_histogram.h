@@ -0,0 +1,62 @@
+/*******************************************************************************
+Title           : latency_histogram.h
+Created on      : Oct 19, 2026
+Description     : Interface of the LatencyHistogram class
+Purpose         : Keeps the distribution of many timings in a fixed amount of
+                  memory, so that percentiles can be reported at the end of a
+                  run without storing every timing
+*******************************************************************************/
+
+#ifndef SW2_LATENCY_HISTOGRAM_H_
+#define SW2_LATENCY_HISTOGRAM_H_
+
+using namespace std;
+
+/** class LatencyHistogram counts values in logarithmic buckets, as HDR
+ *  histograms do: every power of two is split into SUB_BUCKETS buckets of
+ *  equal width, so a value is known to within 1/SUB_BUCKETS of itself,
+ *  whether it is a microsecond or a minute. Values below SUB_BUCKETS are
+ *  counted exactly. record() only does relaxed atomic increments, so any
+ *  number of threads may record at once.
+ */
+class LatencyHistogram{
+    public:
+
+    static const int SUB_BUCKET_BITS=5;
+    static const int SUB_BUCKETS=1<<SUB_BUCKET_BITS;
+    static const int NUM_BUCKETS=(64-SUB_BUCKET_BITS+1)*SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &)=delete;
+
+    LatencyHistogram &operator =(const LatencyHistogram &)=delete;
+
+    /** record(value) counts one value, in nanoseconds */
+    void record(uint64_t value);
+
+    /** count() returns how many values were recorded */
+    uint64_t count() const;
+
+    /** max() returns the largest value recorded, or 0 */
+    uint64_t max() const;
+
+    /** mean() returns the average of the values recorded, or 0 */
+    double mean() const;
+
+    /** percentile(p) returns a value that at least the part p (0 to 1) of
+     *  the recorded values are at or below: the top of the bucket the
+     *  value of that rank is in, but never more than max()
+     */
+    uint64_t percentile(double p) const;
+
+    private:
+
+    atomic<uint64_t> buckets[NUM_BUCKETS];
+    atomic<uint64_t> total, sum, largest;
+
+    static int bucket_of(uint64_t value);
+    static uint64_t bucket_top(int bucket);
+};
+
+#endif //SW2_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,169 @@
+/**
+    perf_counters.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement perf_counters class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char *COUNTER_NAMES[num_Perf_counters]={"cycles", "instructions",
+                                              "l1d_misses", "llc_misses",
+                                              "branch_misses"};
+
+/****************************Helper Functions**********************************/
+
+const char *counter_name(Perf_counter counter){
+    return COUNTER_NAMES[counter];
+}
+
+#ifdef __linux__
+//the perf_event type and config of each counter
+const uint32_t COUNTER_TYPES[num_Perf_counters]={
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+};
+const uint64_t COUNTER_CONFIGS[num_Perf_counters]={
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ<<8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS<<16),
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+//opens one counter of the calling thread, in the group of leader, or as
+//the leader if that is -1; returns the descriptor or -1
+int open_counter(Perf_counter counter, int leader){
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size=sizeof attr;
+    attr.type=COUNTER_TYPES[counter];
+    attr.config=COUNTER_CONFIGS[counter];
+    attr.disabled=leader<0;
+    attr.exclude_kernel=1;
+    attr.exclude_hv=1;
+    attr.read_format=PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif
+
+/****************************PerfCounters Class********************************/
+
+PerfCounters::PerfCounters(): leader(-1), opened(0){
+    for(int c=0; c<num_Perf_counters; c++){
+        fds[c]=-1;
+        position[c]=-1;
+    }
+#ifdef __linux__
+    for(int c=0; c<num_Perf_counters; c++){
+        fds[c]=open_counter((Perf_counter)c, leader);
+        if(fds[c]<0){
+            if(why.empty())
+                why=string("perf_event_open ")+COUNTER_NAMES[c]+": "+
+                    strerror(errno);
+            continue;
+        }
+        if(leader<0)
+            leader=fds[c];
+        position[c]=opened++;
+    }
+    if(leader>=0){
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    why="hardware counters are only read on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters(){
+#ifdef __linux__
+    for(int fd:fds)
+        if(fd>=0)
+            close(fd);
+#endif
+}
+
+PerfCounters &PerfCounters::local(){
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+bool PerfCounters::available() const{
+    return has(cycles_counter) && has(instructions_counter);
+}
+
+bool PerfCounters::has(Perf_counter counter) const{
+    return position[counter]>=0;
+}
+
+const string &PerfCounters::error() const{
+    return why;
+}
+
+void PerfCounters::read(uint64_t counts[num_Perf_counters]) const{
+    for(int c=0; c<num_Perf_counters; c++)
+        counts[c]=0;
+#ifdef __linux__
+    if(leader<0)
+        return;
+    //nr, time enabled, time running, then one value per counter
+    uint64_t data[3+num_Perf_counters];
+    if(::read(leader, data, sizeof data)<(ssize_t)(3*sizeof(uint64_t)))
+        return;
+    double scale=data[2]>0?(double)data[1]/data[2]:0;
+    for(int c=0; c<num_Perf_counters; c++)
+        if(position[c]>=0 && (uint64_t)position[c]<data[0])
+            counts[c]=(uint64_t)(data[3+position[c]]*scale);
+#endif
+}
+
+/****************************CounterTotals Class*******************************/
+
+CounterTotals::CounterTotals(){
+    for(auto &t:totals)
+        t.store(0, memory_order_relaxed);
+}
+
+void CounterTotals::add(const uint64_t counts[num_Perf_counters]){
+    for(int c=0; c<num_Perf_counters; c++)
+        totals[c].fetch_add(counts[c], memory_order_relaxed);
+}
+
+uint64_t CounterTotals::total(Perf_counter counter) const{
+    return totals[counter].load(memory_order_relaxed);
+}
+
+/****************************CounterScope Class********************************/
+
+CounterScope::CounterScope(CounterTotals *_totals): totals(_totals){
+    if(totals!=nullptr)
+        PerfCounters::local().read(start);
+}
+
+CounterScope::~CounterScope(){
+    if(totals==nullptr)
+        return;
+    uint64_t end[num_Perf_counters];
+    PerfCounters::local().read(end);
+    for(int c=0; c<num_Perf_counters; c++)
+        end[c]=end[c]>start[c]?end[c]-start[c]:0;
+    totals->add(end);
+}
@@ -0,0 +1,116 @@
+/*******************************************************************************
+Title           : perf_counters.h
+Created on      : Oct 19, 2026
+Description     : Interface of the PerfCounters, CounterTotals and
+                  CounterScope classes
+Purpose         : Reads the hardware performance counters of the CPU through
+                  Linux perf_event_open, so that a slow step can be told to be
+                  bound by cache misses, branch mispredictions or plain work
+*******************************************************************************/
+
+#ifndef SW2_PERF_COUNTERS_H_
+#define SW2_PERF_COUNTERS_H_
+
+using namespace std;
+
+/** Perf_counter:
+    The counters of a group. Any of them may be missing on a given CPU or
+    virtual machine; a missing counter reads 0.
+*/
+typedef enum{
+    cycles_counter=0,
+    instructions_counter,
+    l1d_misses_counter,         // L1 data cache read misses
+    llc_misses_counter,         // last level cache misses
+    branch_misses_counter,
+    num_Perf_counters
+}Perf_counter;
+
+/** class PerfCounters is a group of the counters above that counts the
+ *  user-space work of the thread that opened it. The counters are read
+ *  together, and scaled up if the kernel had to share the hardware with
+ *  other groups. Where perf_event_open is not allowed, as in most
+ *  containers, nothing opens and every read is 0.
+ */
+class PerfCounters{
+    public:
+
+    /** PerfCounters() opens the group on the calling thread */
+    PerfCounters();
+
+    PerfCounters(const PerfCounters &)=delete;
+
+    PerfCounters &operator =(const PerfCounters &)=delete;
+
+    ~PerfCounters();
+
+    /** local() returns the group of the calling thread, opened on its first
+     *  call on that thread
+     */
+    static PerfCounters &local();
+
+    /** available() returns true if at least cycles and instructions opened */
+    bool available() const;
+
+    /** has(c) returns true if counter c opened */
+    bool has(Perf_counter counter) const;
+
+    /** error() returns why the group is not available, or "" */
+    const string &error() const;
+
+    /** read(counts) fills counts with the totals of the group so far */
+    void read(uint64_t counts[num_Perf_counters]) const;
+
+    private:
+
+    int leader;
+    int fds[num_Perf_counters];
+    int position[num_Perf_counters];    // in the group read, or -1
+    int opened;
+    string why;
+};
+
+/** class CounterTotals adds up counts from any number of threads */
+class CounterTotals{
+    public:
+
+    CounterTotals();
+
+    CounterTotals(const CounterTotals &)=delete;
+
+    CounterTotals &operator =(const CounterTotals &)=delete;
+
+    void add(const uint64_t counts[num_Perf_counters]);
+
+    uint64_t total(Perf_counter counter) const;
+
+    private:
+
+    atomic<uint64_t> totals[num_Perf_counters];
+};
+
+/** class CounterScope adds what the group of the calling thread counted
+ *  from its construction to the end of its scope to totals. It does
+ *  nothing if totals is nullptr.
+ */
+class CounterScope{
+    public:
+
+    explicit CounterScope(CounterTotals *totals);
+
+    CounterScope(const CounterScope &)=delete;
+
+    CounterScope &operator =(const CounterScope &)=delete;
+
+    ~CounterScope();
+
+    private:
+
+    CounterTotals *totals;
+    uint64_t start[num_Perf_counters];
+};
+
+/** counter_name(c) returns the name of counter c for reports */
+const char *counter_name(Perf_counter counter);
+
+#endif //SW2_PERF_COUNTERS_H_
@@ -0,0 +1,285 @@
+/**
+    run_stats.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement run_stats class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "run_stats.h"
+#include "../ResultWriter/result_writer.h"
+
+const char *PHASE_NAMES[num_Load_phases]={"read", "parse", "validate",
+                                          "insert"};
+
+/****************************Helper Functions**********************************/
+
+//the width of the name column of the tables, wide enough for every command
+//name and a space after it
+int name_width(){
+    static const int width=[]{
+        size_t longest=strlen("command");
+        for(int t=0; t<num_Command_types; t++)
+            longest=max(longest, strlen(command_name((Command_type)t)));
+        return (int)longest+1;
+    }();
+    return width;
+}
+
+//the rows the counters of a command type are divided by: the trees its
+//commands scanned, or the commands if they scan none
+long counted_rows(long scanned, uint64_t commands){
+    return scanned>0?scanned:commands;
+}
+
+//one row of the counters table: instructions per cycle, then the other
+//counters per row
+void counter_row(ostream &out, const char *step, const CounterTotals &c,
+                 long rows, const PerfCounters &group){
+    out<<"  "<<left<<setw(name_width())<<step<<right<<setprecision(2);
+    uint64_t cycles=c.total(cycles_counter);
+    if(cycles>0)
+        out<<setw(7)<<(double)c.total(instructions_counter)/cycles;
+    else
+        out<<setw(7)<<"-";
+    for(Perf_counter k:{cycles_counter, l1d_misses_counter,
+                        llc_misses_counter, branch_misses_counter})
+        if(group.has(k) && rows>0)
+            out<<setw(12)<<(double)c.total(k)/rows;
+        else
+            out<<setw(12)<<"-";
+    out<<"\n";
+}
+
+//writes the counters of one step as a JSON object, null for the counters
+//that did not open
+void counter_object(ostream &out, const CounterTotals &c, long rows,
+                    const PerfCounters &group){
+    out<<"{\"rows\":"<<rows;
+    for(int k=0; k<num_Perf_counters; k++){
+        out<<",\""<<counter_name((Perf_counter)k)<<"\":";
+        if(group.has((Perf_counter)k))
+            out<<c.total((Perf_counter)k);
+        else
+            out<<"null";
+    }
+    out<<"}";
+}
+
+/****************************RunStats Class************************************/
+
+RunStats::RunStats(): on(false), counting(false), bad_rows(0){
+    for(auto &p:phases){
+        p.ns=0;
+        p.rows=0;
+        p.bytes=0;
+    }
+    for(auto &c:commands){
+        c.scanned=0;
+        c.returned=0;
+    }
+}
+
+RunStats &RunStats::instance(){
+    static RunStats stats;
+    return stats;
+}
+
+void RunStats::enable(){
+    on.store(true, memory_order_relaxed);
+}
+
+bool RunStats::enabled() const{
+    return on.load(memory_order_relaxed);
+}
+
+void RunStats::enable_counters(){
+    counting.store(true, memory_order_relaxed);
+}
+
+CounterTotals *RunStats::phase_counters(Load_phase phase){
+    return counting.load(memory_order_relaxed)?&phases[phase].counters
+                                              :nullptr;
+}
+
+CounterTotals *RunStats::command_counters(Command_type type){
+    return counting.load(memory_order_relaxed)?&commands[type].counters
+                                              :nullptr;
+}
+
+void RunStats::record_phase(Load_phase phase, uint64_t ns, long rows,
+                            long bytes){
+    phases[phase].ns.fetch_add(ns, memory_order_relaxed);
+    phases[phase].rows.fetch_add(rows, memory_order_relaxed);
+    phases[phase].bytes.fetch_add(bytes, memory_order_relaxed);
+}
+
+void RunStats::record_bad_rows(long n){
+    bad_rows.fetch_add(n, memory_order_relaxed);
+}
+
+void RunStats::record_command(Command_type type, uint64_t ns, long scanned,
+                              long returned){
+    commands[type].latency.record(ns);
+    commands[type].scanned.fetch_add(scanned, memory_order_relaxed);
+    commands[type].returned.fetch_add(returned, memory_order_relaxed);
+}
+
+uint64_t RunStats::load_ns() const{
+    uint64_t ns=0;
+    for(const auto &p:phases)
+        ns+=p.ns.load(memory_order_relaxed);
+    return ns;
+}
+
+void RunStats::write_text(ostream &out) const{
+    ostringstream text;
+    text<<fixed;
+    long rows=phases[read_phase].rows;
+    double bytes=phases[read_phase].bytes;
+    double seconds=load_ns()/1e9;
+    if(rows>0){
+        text<<"Load: "<<rows<<" rows, "<<setprecision(1)<<bytes/(1<<20)
+            <<" MB, "<<bad_rows<<" bad, in "<<setprecision(3)<<seconds
+            <<" s: "<<setprecision(0)<<(seconds>0?rows/seconds:0)
+            <<" rows/s, "<<setprecision(1)
+            <<(seconds>0?bytes/(1<<20)/seconds:0)<<" MB/s\n"
+            <<"  phase              ms     ns/row   share\n";
+        for(int i=0; i<num_Load_phases; i++){
+            double ns=phases[i].ns;
+            text<<"  "<<left<<setw(10)<<PHASE_NAMES[i]<<right
+                <<setw(10)<<setprecision(1)<<ns/1e6<<setw(11)<<ns/rows
+                <<setw(7)<<setprecision(1)
+                <<(seconds>0?100*ns/1e9/seconds:0)<<"%\n";
+        }
+    }
+    text<<"Commands:\n  "<<left<<setw(name_width())<<"command"<<right<<setw(7)
+        <<"count"<<setw(10)<<"p50_us"<<setw(10)<<"p90_us"<<setw(10)
+        <<"p99_us"<<setw(10)<<"max_us"<<setw(12)<<"scanned"<<setw(10)
+        <<"returned"<<"\n"<<setprecision(1);
+    for(int t=0; t<num_Command_types; t++){
+        const CommandStats &c=commands[t];
+        if(c.latency.count()==0)
+            continue;
+        text<<"  "<<left<<setw(name_width())<<command_name((Command_type)t)
+            <<right
+            <<setw(7)<<c.latency.count()
+            <<setw(10)<<c.latency.percentile(0.50)/1e3
+            <<setw(10)<<c.latency.percentile(0.90)/1e3
+            <<setw(10)<<c.latency.percentile(0.99)/1e3
+            <<setw(10)<<c.latency.max()/1e3<<setw(12)<<c.scanned
+            <<setw(10)<<c.returned<<"\n";
+    }
+    if(counting)
+        write_counters_text(text);
+    out<<text.str()<<flush;
+}
+
+void RunStats::write_json(ostream &out) const{
+    ostringstream json;
+    uint64_t ns=load_ns();
+    long rows=phases[read_phase].rows;
+    json<<"{\"load\":{\"rows\":"<<rows<<",\"bytes\":"
+        <<phases[read_phase].bytes<<",\"bad_rows\":"<<bad_rows<<",\"ns\":"
+        <<ns<<",\"rows_per_s\":"<<(ns>0?(uint64_t)(rows*1e9/ns):0)
+        <<",\"phases\":{";
+    for(int i=0; i<num_Load_phases; i++)
+        json<<(i?",":"")<<"\""<<PHASE_NAMES[i]<<"_ns\":"<<phases[i].ns;
+    json<<"}},\"commands\":[";
+    bool first=true;
+    for(int t=0; t<num_Command_types; t++){
+        const CommandStats &c=commands[t];
+        if(c.latency.count()==0)
+            continue;
+        json<<(first?"":",")<<"{\"command\":\""
+            <<command_name((Command_type)t)<<"\",\"count\":"
+            <<c.latency.count()<<",\"p50_ns\":"<<c.latency.percentile(0.50)
+            <<",\"p90_ns\":"<<c.latency.percentile(0.90)<<",\"p99_ns\":"
+            <<c.latency.percentile(0.99)<<",\"max_ns\":"<<c.latency.max()
+            <<",\"mean_ns\":"<<(uint64_t)c.latency.mean()
+            <<",\"rows_scanned\":"<<c.scanned<<",\"rows_returned\":"
+            <<c.returned<<"}";
+        first=false;
+    }
+    json<<"]";
+    if(counting)
+        write_counters_json(json);
+    json<<"}\n";
+    out<<json.str()<<flush;
+}
+
+void RunStats::write_counters_text(ostream &out) const{
+    const PerfCounters &group=PerfCounters::local();
+    if(!group.available()){
+        out<<"Counters: not available ("<<group.error()<<")\n";
+        return;
+    }
+    out<<"Counters: per data row for the load, per tree scanned for the "
+         "commands\n(per command for those that scan none), user space only";
+    if(!group.error().empty())
+        out<<"; "<<group.error();
+    out<<"\n  "<<left<<setw(name_width())<<"step"<<right<<setw(7)<<"IPC"
+       <<setw(12)<<"cycles"<<setw(12)<<"L1D_misses"<<setw(12)
+       <<"LLC_misses"<<setw(12)<<"br_misses"<<"\n";
+    for(int i=0; i<num_Load_phases; i++)
+        counter_row(out, PHASE_NAMES[i], phases[i].counters, phases[i].rows,
+                    group);
+    for(int t=0; t<num_Command_types; t++){
+        const CommandStats &c=commands[t];
+        if(c.latency.count()>0)
+            counter_row(out, command_name((Command_type)t), c.counters,
+                        counted_rows(c.scanned, c.latency.count()), group);
+    }
+}
+
+void RunStats::write_counters_json(ostream &out) const{
+    const PerfCounters &group=PerfCounters::local();
+    out<<",\"counters\":{\"available\":"<<(group.available()?"true":"false")
+       <<",\"error\":\""<<group.error()<<"\"";
+    if(group.available()){
+        out<<",\"phases\":{";
+        for(int i=0; i<num_Load_phases; i++){
+            out<<(i?",":"")<<"\""<<PHASE_NAMES[i]<<"\":";
+            counter_object(out, phases[i].counters, phases[i].rows, group);
+        }
+        out<<"},\"commands\":{";
+        bool first=true;
+        for(int t=0; t<num_Command_types; t++){
+            const CommandStats &c=commands[t];
+            if(c.latency.count()==0)
+                continue;
+            out<<(first?"":",")<<"\""<<command_name((Command_type)t)<<"\":";
+            counter_object(out, c.counters,
+                           counted_rows(c.scanned, c.latency.count()), group);
+            first=false;
+        }
+        out<<"}";
+    }
+    out<<"}";
+}
+
+/****************************StatsReport Class*********************************/
+
+StatsReport::StatsReport(Stats_format _format, ostream &_out,
+                         bool counters): format(_format), out(_out){
+    if(format!=no_stats)
+        RunStats::instance().enable();
+    if(format!=no_stats && counters)
+        RunStats::instance().enable_counters();
+}
+
+StatsReport::~StatsReport(){
+    if(format==text_stats)
+        RunStats::instance().write_text(out);
+    else if(format==json_stats)
+        RunStats::instance().write_json(out);
+}
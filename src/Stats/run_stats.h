@@ -0,0 +1,150 @@
+/*******************************************************************************
+Title           : run_stats.h
+Created on      : Oct 19, 2026
+Description     : Interface of the RunStats and StatsReport classes
+Purpose         : Collects how long the phases of loading and every command
+                  took, and how many trees each command looked at, so that
+                  the slow parts of a run can be found
+*******************************************************************************/
+
+#ifndef SW2_RUN_STATS_H_
+#define SW2_RUN_STATS_H_
+
+#include "../Command/command.h"
+#include "latency_histogram.h"
+#include "perf_counters.h"
+
+using namespace std;
+
+/** Load_phase:
+    The steps a chunk of the data file goes through in TreeLoader::load.
+    Tree(str) checks the fields as it parses them, so parse_phase includes
+    that; validate_phase is the pass that rejects and reports the bad lines.
+*/
+typedef enum{
+    read_phase=0,
+    parse_phase,
+    validate_phase,
+    insert_phase,
+    num_Load_phases
+}Load_phase;
+
+/** Stats_format:
+    How StatsReport writes the stats.
+*/
+typedef enum{
+    no_stats=0,
+    text_stats,
+    json_stats
+}Stats_format;
+
+/** class RunStats collects the stats of the whole program. Nothing is
+ *  recorded until enable() is called, and the callers skip their timing
+ *  while enabled() is false, so a run without --stats pays for one load
+ *  of a flag per command or chunk. Any thread may record.
+ */
+class RunStats{
+    public:
+
+    RunStats();
+
+    RunStats(const RunStats &)=delete;
+
+    RunStats &operator =(const RunStats &)=delete;
+
+    /** instance() returns the stats of the program */
+    static RunStats &instance();
+
+    void enable();
+
+    bool enabled() const;
+
+    /** enable_counters() also reads the hardware counters around each load
+     *  phase and command (see PerfCounters)
+     */
+    void enable_counters();
+
+    /** phase_counters(p) and command_counters(t) return where the counters
+     *  of phase p or commands of type t add up, or nullptr if the counters
+     *  are not enabled, so that they can be given to a CounterScope
+     */
+    CounterTotals *phase_counters(Load_phase phase);
+
+    CounterTotals *command_counters(Command_type type);
+
+    /** record_phase(phase,ns,rows,bytes) adds ns nanoseconds spent in phase
+     *  on rows lines of bytes bytes
+     */
+    void record_phase(Load_phase phase, uint64_t ns, long rows,
+                      long bytes=0);
+
+    /** record_bad_rows(n) counts n lines that were rejected */
+    void record_bad_rows(long n);
+
+    /** record_command(type,ns,scanned,returned) counts one command of type
+     *  that took ns nanoseconds, looked at scanned trees and produced
+     *  returned result rows
+     */
+    void record_command(Command_type type, uint64_t ns, long scanned,
+                        long returned);
+
+    /** write_text(out) writes a table of the stats for people to read */
+    void write_text(ostream &out) const;
+
+    /** write_json(out) writes the stats as one JSON object */
+    void write_json(ostream &out) const;
+
+    private:
+
+    struct Phase{
+        atomic<uint64_t> ns;
+        atomic<long> rows, bytes;
+        CounterTotals counters;
+    };
+
+    struct CommandStats{
+        LatencyHistogram latency;
+        atomic<long> scanned, returned;
+        CounterTotals counters;
+    };
+
+    atomic<bool> on, counting;
+    Phase phases[num_Load_phases];
+    atomic<long> bad_rows;
+    CommandStats commands[num_Command_types];
+
+    uint64_t load_ns() const;
+
+    void write_counters_text(ostream &out) const;
+
+    void write_counters_json(ostream &out) const;
+};
+
+/** class StatsReport writes the stats of the program in format on out when
+ *  it goes out of scope, if format is not no_stats. Creating one with a
+ *  format enables the stats, and the hardware counters if counters is true.
+ */
+class StatsReport{
+    public:
+
+    StatsReport(Stats_format format, ostream &out, bool counters=false);
+
+    StatsReport(const StatsReport &)=delete;
+
+    StatsReport &operator =(const StatsReport &)=delete;
+
+    ~StatsReport();
+
+    private:
+
+    Stats_format format;
+    ostream &out;
+};
+
+/** now_ns() reads the monotonic clock, in nanoseconds */
+inline uint64_t now_ns(){
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif //SW2_RUN_STATS_H_
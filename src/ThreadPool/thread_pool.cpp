@@ -0,0 +1,73 @@
+/**
+    thread_pool.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement thread_pool class
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "thread_pool.h"
+
+/****************************ThreadPool Class**********************************/
+
+ThreadPool::ThreadPool(size_t threads): stopping(false){
+    if(threads==0)
+        threads=max(1u, thread::hardware_concurrency());
+    for(size_t i=0; i<threads; i++)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool(){
+    shutdown();
+}
+
+bool ThreadPool::submit(function<void()> task){
+    {
+        lock_guard<mutex> guard(lock);
+        if(stopping)
+            return false;
+        tasks.push(move(task));
+    }
+    ready.notify_one();
+    return true;
+}
+
+void ThreadPool::shutdown(){
+    {
+        lock_guard<mutex> guard(lock);
+        stopping=true;
+    }
+    ready.notify_all();
+    for(auto &worker:workers)
+        if(worker.joinable())
+            worker.join();
+}
+
+size_t ThreadPool::size() const{
+    return workers.size();
+}
+
+//runs tasks until the pool is stopping and the queue is empty
+void ThreadPool::work(){
+    while(true){
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, [this]{ return stopping || !tasks.empty(); });
+            if(tasks.empty())
+                return;
+            task=move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+Title           : thread_pool.h
+Created on      : Oct 19, 2026
+Description     : Interface of the ThreadPool class
+Purpose         : A fixed set of worker threads that run submitted tasks in
+                  the order they were submitted
+*******************************************************************************/
+
+#ifndef SW2_THREAD_POOL_H_
+#define SW2_THREAD_POOL_H_
+
+using namespace std;
+
+/** class ThreadPool starts its workers in the constructor. Tasks are taken
+ *  from one shared FIFO queue. shutdown(), also called by the destructor,
+ *  lets the workers finish every task already submitted and joins them.
+ */
+class ThreadPool{
+    public:
+    
+    /** ThreadPool(n) starts n workers, or one per hardware thread if n is 0
+     */
+    explicit ThreadPool(size_t threads=0);
+    
+    ThreadPool(const ThreadPool &)=delete;
+    
+    ThreadPool &operator =(const ThreadPool &)=delete;
+    
+    ~ThreadPool();
+    
+    /** submit(task) queues task to run on one of the workers
+     *  @return bool false if the pool is shut down and the task was dropped
+     */
+    bool submit(function<void()> task);
+    
+    /** shutdown() waits for all submitted tasks, then stops the workers */
+    void shutdown();
+    
+    size_t size() const;
+    
+    private:
+    
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex lock;
+    condition_variable ready;
+    bool stopping;
+    
+    void work();
+};
+
+#endif //SW2_THREAD_POOL_H_
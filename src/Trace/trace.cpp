@@ -0,0 +1,99 @@
+/**
+    trace.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement trace class
+
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "trace.h"
+
+// spans a buffer holds before it first grows
+const size_t BUFFER_RESERVE=4096;
+
+/****************************Tracer Class**************************************/
+
+Tracer::Tracer(): on(false), origin(0){}
+
+Tracer &Tracer::instance(){
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable(){
+    origin=now_ns();
+    on.store(true, memory_order_release);
+}
+
+bool Tracer::enabled() const{
+    return on.load(memory_order_relaxed);
+}
+
+void Tracer::record(const char *category, const char *name, uint64_t begin,
+                    uint64_t end){
+    local_buffer().events.push_back({category, name, begin, end});
+}
+
+//the buffer of the calling thread, made on its first span; the tracer owns
+//it, so its spans outlive the thread
+Tracer::Buffer &Tracer::local_buffer(){
+    thread_local Buffer *buffer=nullptr;
+    if(buffer==nullptr){
+        lock_guard<mutex> guard(buffers_lock);
+        buffers.push_back(make_unique<Buffer>());
+        buffer=buffers.back().get();
+        buffer->thread=buffers.size();
+        buffer->events.reserve(BUFFER_RESERVE);
+    }
+    return *buffer;
+}
+
+//timestamps are in microseconds from enable(), with nanosecond decimals
+void Tracer::write_json(ostream &out) const{
+    ostringstream json;
+    json<<fixed<<setprecision(3)<<"{\"displayTimeUnit\":\"ms\","
+          "\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\","
+          "\"pid\":1,\"args\":{\"name\":\"NYCTreeInfo\"}}";
+    lock_guard<mutex> guard(buffers_lock);
+    for(const auto &buffer:buffers){
+        json<<",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            <<buffer->thread<<",\"args\":{\"name\":\"thread "<<buffer->thread
+            <<"\"}}";
+        for(const Event &e:buffer->events)
+            json<<",\n{\"name\":\""<<e.name<<"\",\"cat\":\""<<e.category
+                <<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<buffer->thread
+                <<",\"ts\":"<<(e.begin-min(e.begin, origin))/1e3
+                <<",\"dur\":"<<(e.end-e.begin)/1e3<<"}";
+    }
+    json<<"\n]}\n";
+    out<<json.str()<<flush;
+}
+
+/****************************TraceReport Class*********************************/
+
+TraceReport::TraceReport(const string &_path): path(_path){
+    if(path.empty())
+        return;
+#ifdef NYC_TREES_NO_TRACE
+    cerr<<"This build has no trace spans; "<<path<<" will be empty"<<endl;
+#endif
+    Tracer::instance().enable();
+}
+
+TraceReport::~TraceReport(){
+    if(path.empty())
+        return;
+    ofstream out(path);
+    Tracer::instance().write_json(out);
+    if(out.fail())
+        cerr<<"Could not write trace file "<<path<<endl;
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+Title           : trace.h
+Created on      : Oct 19, 2026
+Description     : Interface of the Tracer, TraceSpan and TraceReport classes
+Purpose         : Records when the steps of loading and each command started
+                  and ended, on every thread, and writes them as a Chrome
+                  trace_event file that Perfetto or chrome://tracing show as a
+                  timeline
+*******************************************************************************/
+
+#ifndef SW2_TRACE_H_
+#define SW2_TRACE_H_
+
+#include "../Stats/run_stats.h"
+
+using namespace std;
+
+/** class Tracer keeps the spans of the program. Each thread appends to a
+ *  buffer of its own, so recording takes no lock once a thread has its
+ *  buffer. Nothing is recorded until enable() is called.
+ */
+class Tracer{
+    public:
+
+    Tracer();
+
+    Tracer(const Tracer &)=delete;
+
+    Tracer &operator =(const Tracer &)=delete;
+
+    /** instance() returns the tracer of the program */
+    static Tracer &instance();
+
+    void enable();
+
+    bool enabled() const;
+
+    /** record(c,n,begin,end) adds a span of category c and name n that
+     *  lasted from begin to end, in now_ns() time. c and n are not copied
+     *  and must be string literals or live as long.
+     */
+    void record(const char *category, const char *name, uint64_t begin,
+                uint64_t end);
+
+    /** write_json(out) writes every span as Chrome trace_event JSON. No
+     *  thread may be recording while it runs.
+     */
+    void write_json(ostream &out) const;
+
+    private:
+
+    struct Event{
+        const char *category;
+        const char *name;
+        uint64_t begin, end;
+    };
+
+    struct Buffer{
+        int thread;
+        vector<Event> events;
+    };
+
+    atomic<bool> on;
+    uint64_t origin;
+    mutable mutex buffers_lock;
+    vector<unique_ptr<Buffer>> buffers;
+
+    Buffer &local_buffer();
+};
+
+/** class TraceSpan records one span from its construction to the end of its
+ *  scope, if the tracer was enabled when it was made. Use it through
+ *  TRACE_SPAN, which builds to nothing when NYC_TREES_NO_TRACE is defined.
+ */
+class TraceSpan{
+    public:
+
+    TraceSpan(const char *category, const char *name);
+
+    TraceSpan(const TraceSpan &)=delete;
+
+    TraceSpan &operator =(const TraceSpan &)=delete;
+
+    ~TraceSpan();
+
+    private:
+
+    const char *category;
+    const char *name;
+    uint64_t begin;     // 0 if the tracer was off
+};
+
+inline TraceSpan::TraceSpan(const char *_category, const char *_name):
+                            category(_category), name(_name),
+                            begin(Tracer::instance().enabled()?now_ns():0){}
+
+inline TraceSpan::~TraceSpan(){
+    if(begin!=0)
+        Tracer::instance().record(category, name, begin, now_ns());
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef NYC_TREES_NO_TRACE
+#define TRACE_SPAN(category, name) do{}while(0)
+#else
+#define TRACE_SPAN(category, name) \
+    TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(category, name)
+#endif
+
+/** class TraceReport writes the spans of the program to the file at path
+ *  when it goes out of scope, if path is not empty. Creating one with a
+ *  path enables the tracer.
+ */
+class TraceReport{
+    public:
+
+    explicit TraceReport(const string &path);
+
+    TraceReport(const TraceReport &)=delete;
+
+    TraceReport &operator =(const TraceReport &)=delete;
+
+    ~TraceReport();
+
+    private:
+
+    string path;
+};
+
+#endif //SW2_TRACE_H_
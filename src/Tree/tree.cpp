@@ -19,6 +19,8 @@
 
 #include "tree.h"
 
+const int DATA_FIELDS=41;       // columns of a row of the data file
+
 /****************************Helper Functions**********************************/
 
 //checks if the string only has numeric value;
@@ -36,27 +38,59 @@ bool is_numeric(const char *string){
     return isNumeric;
 }
 
-//to lower case string
-string lower(string str){
-    transform(str.begin(), str.end(), str.begin(),
-              [](unsigned char c){ return tolower(c); });
-    return str;
+//reads all of s as an int; false for a field is_numeric() lets through
+//that is still not one, such as an empty field, "-" or "1.5"
+bool read_int(const string &s, int &value){
+    if(s.empty() || !is_numeric(s.c_str()))
+        return false;
+    char *end;
+    errno=0;
+    long n=strtol(s.c_str(), &end, 10);
+    if(*end!='\0' || errno==ERANGE || n<INT_MIN || n>INT_MAX)
+        return false;
+    value=(int)n;
+    return true;
+}
+
+//reads all of s as a finite double, as read_int() reads an int
+bool read_double(const string &s, double &value){
+    if(s.empty() || !is_numeric(s.c_str()))
+        return false;
+    char *end;
+    double d=strtod(s.c_str(), &end);
+    if(*end!='\0' || !isfinite(d))
+        return false;
+    value=d;
+    return true;
+}
+
+//compares the lower case forms of two strings, as comparing lowered copies
+//would, without making the copies; returns <0, 0 or >0
+int compare_lower(const string &lhs, const string &rhs){
+    size_t n=min(lhs.size(), rhs.size());
+    for(size_t i=0; i<n; i++){
+        int l=tolower((unsigned char)lhs[i]), r=tolower((unsigned char)rhs[i]);
+        if(l!=r)
+            return l<r?-1:1;
+    }
+    return lhs.size()<rhs.size()?-1:lhs.size()>rhs.size()?1:0;
 }
 
 //for case insensitivity
 bool match(const string &lhs, const string &rhs){
-    return lower(lhs)==lower(rhs);
+    return lhs.size()==rhs.size() && compare_lower(lhs, rhs)==0;
 }
 
 /****************************Tree Class****************************************/
 
-/** Tree(int=0, string="", double=0, double=0) is a default constructor */
-Tree::Tree(int zip, string name, double lat, double lon):tree_id(0),
+/** Tree(int=0, string="", double=0, double=0, int=0) is a default constructor */
+Tree::Tree(int zip, string name, double lat, double lon, int id):tree_id(id),
         tree_dbh(0),spc_common(name),zipcode(zip),latitude(lat),longitude(lon){}
         
 /** Tree(str) is a constructor which processes a csv string and store
   * values to corresponding member variables */
-Tree::Tree(const std::string &str){
+Tree::Tree(const std::string &str):tree_id(0),tree_dbh(0),zipcode(0),
+        latitude(0),longitude(0){
     
     stringstream ss(str);
     string temp;
@@ -74,35 +108,28 @@ Tree::Tree(const std::string &str){
         
         switch(i++){            //set corresponding fields
             case 0:
-                if(is_numeric(temp.c_str()))
-                    tree_id=stoi(temp);
-                else valid_data=false;
+                if(!read_int(temp, tree_id))
+                    valid_data=false;
                 break;
             case 1:
-                if(is_numeric(temp.c_str()))
-                    tree_dbh=stoi(temp);
-                else valid_data=false;
+                if(!read_int(temp, tree_dbh))
+                    valid_data=false;
                 break;
             case 6:
-                if(temp.empty() || temp=="Alive" || temp=="Dead" ||
-                   temp=="Stump")
-                    status=temp;
-                else valid_data=false;
+                if(!set_status(temp))
+                    valid_data=false;
                 break;
             case 7:
-                if(temp.empty() || temp=="Good" || temp=="Fair" || temp=="Poor")
-                    health=temp;
-                else valid_data=false;
+                if(!set_health(temp))
+                    valid_data=false;
                 break;
-            case 9:spc_common=temp;
+            case 9:spc_common=move(temp);
                 break;
-            case 24:address=temp;
+            case 24:address=move(temp);
                 break;
             case 25:
-                if(is_numeric(temp.c_str()) && stoi(temp)>=0 &&
-                                                            stoi(temp)<100000)
-                    zipcode=stoi(temp);
-                else valid_data=false;
+                if(!read_int(temp, zipcode) || zipcode<0 || zipcode>=100000)
+                    valid_data=false;
                 break;
             case 29:
                 if(temp=="Manhattan" || temp=="Queens" || temp=="Bronx" ||
@@ -113,16 +140,19 @@ Tree::Tree(const std::string &str){
                 }
                 break;
             case 37:
-                if(is_numeric(temp.c_str())) latitude=stod(temp);
-                else valid_data=false;
+                if(!read_double(temp, latitude))
+                    valid_data=false;
                 break;
             case 38:
-                if(is_numeric(temp.c_str())) longitude=stod(temp);
-                else valid_data=false;
+                if(!read_double(temp, longitude))
+                    valid_data=false;
                 break;
             default:break;
         }
     }
+    //a short row leaves the borough and the position unset
+    if(i<DATA_FIELDS)
+        valid_data=false;
     //if data is not valid, set tree_id to 0
     if(!valid_data){
         tree_id=0;
@@ -138,6 +168,41 @@ std::ostream &operator <<(ostream &os, const Tree &t){
     return os;
 }
 
+/* operator<<(out,t)  Buffered insertion with the same format as above */
+BufferedWriter &operator <<(BufferedWriter &out, const Tree &t){
+    out.write(t.spc_common).write(", ", 2).write_int(t.tree_id)
+       .write(", ", 2).write_int(t.tree_dbh).write(", ", 2).write(t.status)
+       .write(", ", 2).write(t.health).write(", ", 2).write_int(t.zipcode)
+       .write(", ", 2).write(t.address).write(", ", 2).write(t.boroname)
+       .write(", ", 2).write_fixed(t.latitude, 5)
+       .write(", ", 2).write_fixed(t.longitude, 5);
+    return out;
+}
+
+/* write_csv(out,t)  writes t in the columns Tree(str) reads */
+BufferedWriter &write_csv(BufferedWriter &out, const Tree &t){
+    //quotes fields that hold the separator, as the census file does
+    auto field=[&out](const string &s){
+        if(s.find(',')==string::npos)
+            out.write(s);
+        else
+            out.put('"').write(s).put('"');
+    };
+    out.write_int(t.tree_id).put(',').write_int(t.tree_dbh).write(",,,,,", 5);
+    field(t.status);
+    out.put(',');
+    field(t.health);
+    out.write(",,", 2);
+    field(t.spc_common);
+    out.write(",,,,,,,,,,,,,,,", 15);
+    field(t.address);
+    out.put(',').write_int(t.zipcode).write(",,,,", 4);
+    field(t.boroname);
+    out.write(",,,,,,,,", 8).write_double(t.latitude).put(',')
+       .write_double(t.longitude).write(",,", 2);
+    return out;
+}
+
 /* operator== (t1,t2)  compares two trees for key pair equality */
 bool operator ==(const Tree &t1, const Tree &t2){
     return t1.tree_id==t2.tree_id && samename(t1, t2);
@@ -145,8 +210,8 @@ bool operator ==(const Tree &t1, const Tree &t2){
 
 /* operator< (t1,t2)  checks if key pair of t1 is less than key pair of t2 */
 bool operator <(const Tree &t1, const Tree &t2){
-    return match(t1.spc_common, t2.spc_common)?t1.tree_id<t2.tree_id:
-           lower(t1.spc_common)<lower(t2.spc_common);
+    int names=compare_lower(t1.spc_common, t2.spc_common);
+    return names==0?t1.tree_id<t2.tree_id:names<0;
 }
 
 /* samename(t1,t2)  checks if the names of t1 and t2 are identical */
@@ -156,7 +221,7 @@ bool samename(const Tree &t1, const Tree &t2){
 
 /* islessname(t1,t2)  checks if the name of t1 precedes name of t2 */
 bool islessname(const Tree &t1, const Tree &t2){
-    return lower(t1.spc_common)<lower(t2.spc_common);
+    return compare_lower(t1.spc_common, t2.spc_common)<0;
 }
 
 /* issamezip(t1,t2)  checks if the zipcode of t1 and t2 are the same */
@@ -171,23 +236,23 @@ bool isclose(const Tree &t1, const Tree &t2, double distance){
 }
 
 /* A bunch of get-functions */
-std::string Tree::common_name() const{
+const std::string &Tree::common_name() const{
     return spc_common;
 }
 
-std::string Tree::borough_name() const{
+const std::string &Tree::borough_name() const{
     return boroname;
 }
 
-std::string Tree::nearest_address() const{
+const std::string &Tree::nearest_address() const{
     return address;
 }
 
-std::string Tree::life_status() const{
+const std::string &Tree::life_status() const{
     return status;
 }
 
-std::string Tree::tree_health() const{
+const std::string &Tree::tree_health() const{
     return health;
 }
 
@@ -209,4 +274,32 @@ void Tree::get_position(double &_latitude, double &_longitude) const{
 }
 
    
-    
\ No newline at end of file
+    
+
+bool Tree::set_status(const string &new_status){
+    if(!(new_status.empty() || new_status=="Alive" || new_status=="Dead" ||
+         new_status=="Stump"))
+        return false;
+    status=new_status;
+    return true;
+}
+
+bool Tree::set_health(const string &new_health){
+    if(!(new_health.empty() || new_health=="Good" || new_health=="Fair" ||
+         new_health=="Poor"))
+        return false;
+    health=new_health;
+    return true;
+}
+
+bool Tree::set_diameter(int new_dbh){
+    if(new_dbh<0)
+        return false;
+    tree_dbh=new_dbh;
+    return true;
+}
+
+size_t Tree::heap_bytes() const{
+    return string_heap(status)+string_heap(health)+string_heap(spc_common)+
+           string_heap(address)+string_heap(boroname);
+}
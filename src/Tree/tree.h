@@ -10,6 +10,8 @@
 #define __Tree_H__
 
 #include "../GPS/gps.h"
+#include "../Output/buffered_writer.h"
+#include "../Memory/memory_usage.h"
 
 using namespace std;
 
@@ -22,16 +24,17 @@ class Tree{
     public:
     
     /** Tree() is a default constructor with default value which can initialize
-     *  field of zipcode, spc_common, latitude and/or longitude.
+     *  field of zipcode, spc_common, latitude, longitude and/or tree_id.
      */
-    explicit Tree(int zip=0, string="", double lat=0, double lon=0);
+    explicit Tree(int zip=0, string="", double lat=0, double lon=0, int id=0);
     
     /** Tree(str) is a constructor that expects a csv string.
      *  The string must contain 41 fields, separated by commas, in the order 
      *  specified in the Data Dictionary from the NYC Open Data website. The
      *  constructor extracts the ten fields listed above, validating each
      *  of them. Each field is expected to be of the correct type. If any are 
-     *  invalid, it creates an empty tree.
+     *  invalid, or the row has fewer fields, it creates an empty tree, with
+     *  id 0. Empty numeric fields are invalid.
      */
     explicit Tree(const string &str);
     
@@ -47,6 +50,14 @@ class Tree{
      */
     friend ostream &operator <<(ostream &os, const Tree &t);
     
+    /** operator<<(out,t)  writes t onto out exactly as operator<<(os,t)
+     *  does, but without touching any stream state.
+     *  @param BufferedWriter out [inout]
+     *  @param Tree           t   [in]
+     *  @return BufferedWriter&
+     */
+    friend BufferedWriter &operator <<(BufferedWriter &out, const Tree &t);
+    
     /** operator== (t1,t2)  compares two trees for key pair equality
      *  @param Tree   t1  [in] 
      *  @param Tree   t2  [in]
@@ -87,21 +98,28 @@ class Tree{
     
     friend bool isclose(const Tree &t1, const Tree &t2, double distance);
     
+    /** write_csv(out,t) writes t as one line of the census CSV file, without
+     *  the '\n'. The fields a Tree keeps are in their columns, the others are
+     *  empty, and Tree(str) reads the line back as the same tree.
+     */
+    friend BufferedWriter &write_csv(BufferedWriter &out, const Tree &t);
+    
     /** A bunch of get-functions
      *  The next nine methods are accessor functions that retrieve the value
      *  of the corresponding private data member. Their meaning should be
      *  clear, possibly except for life_status(), which returns the tree's status
      *  member, and the tree_health() which returns its health member.
+     *  The strings are returned by reference and live as long as the tree.
      */
-    string common_name() const;
+    const string &common_name() const;
     
-    string borough_name() const;
+    const string &borough_name() const;
     
-    string nearest_address() const;
+    const string &nearest_address() const;
     
-    string life_status() const;
+    const string &life_status() const;
     
-    string tree_health() const;
+    const string &tree_health() const;
     
     int id() const;
     
@@ -111,6 +129,21 @@ class Tree{
     
     void get_position(double &latitude, double &longitude) const;
     
+    /** set_status(s), set_health(h) and set_diameter(d) change the fields
+     *  that census updates change. They accept the values Tree(str) accepts
+     *  and return false, leaving the tree as it was, for any other value.
+     */
+    bool set_status(const string &new_status);
+    
+    bool set_health(const string &new_health);
+    
+    bool set_diameter(int new_dbh);
+    
+    /** heap_bytes() returns the heap memory the strings of the tree take,
+     *  not counting the Tree object itself
+     */
+    size_t heap_bytes() const;
+    
     private:
     
     int tree_id;
@@ -125,6 +158,12 @@ class Tree{
     double longitude;
 };
 
+/** compare_lower(a,b) compares the lower case forms of a and b, which is how
+ *  operator< orders the species names
+ *  @return int <0, 0 or >0 as a comes before, with or after b
+ */
+int compare_lower(const string &lhs, const string &rhs);
+
 #endif /* __Tree_H__ */
 
 
@@ -30,13 +30,13 @@ class __TreeCollection{
     /** total_tree_count() returns total number of trees in data set
      *  @return int count of trees in collection  
      */
-    virtual int total_tree_count() = 0;
+    virtual int total_tree_count() const = 0;
     
     /** count_of_tree_species(s) returns number of trees with name s
      * @param  string species_name [in] species name to search for
      * @return int the number of trees that have the given species name
      */
-    virtual int count_of_tree_species(const string &species_name) = 0;
+    virtual int count_of_tree_species(const string &species_name) const = 0;
     
     /** count_of_tree_species_in_boro(s,b) returns number of trees with name s
      *                                     in boro b
@@ -50,7 +50,8 @@ class __TreeCollection{
      * @return int the number of trees in boro that have the given species name
      */
     virtual int count_of_tree_species_in_boro(const string &species_name,
-                                              const string &boro_name) = 0;
+                                              const string &boro_name)
+                                              const = 0;
     
     /** get_counts_of_trees_by_boro(s,t) puts number of trees matching name s
      *                                     in all boros into param t
@@ -68,13 +69,13 @@ class __TreeCollection{
      * @return int the total number of trees of given species in all boros
      */
     virtual int get_counts_of_trees_by_boro(const string &species_name,
-                                            boro tree_count[5]) = 0;
+                                            boro tree_count[5]) const = 0;
     
     /** count_of_trees_in_boro(b) returns number of trees of all types in boro b
      * @param  string boro_name [in] species borough to look in
      * @return int the number of trees in boro boro_name
      */
-    virtual int count_of_trees_in_boro(const string &boro_name) = 0;
+    virtual int count_of_trees_in_boro(const string &boro_name) const = 0;
     
     /** add_tree(t) inserts Tree t into the collection, updates species list and
      *              borough counts. 
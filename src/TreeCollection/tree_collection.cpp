@@ -21,23 +21,73 @@
 
 TreeCollection::TreeCollection(): ITEM_NOT_FOUND(0, "ITEM_NOT_FOUND"), tree_collection
     (ITEM_NOT_FOUND), species(TreeSpecies()){
+    follow_relocations();
 }
 
 TreeCollection::TreeCollection(TreeCollection &rhs): tree_collection
-                                                         (rhs.tree_collection){}
+                                                         (rhs.tree_collection),
+                                                     density(rhs.density){
+    //the copied AvlTree owns new nodes, so point the index at those; the
+    //species are numbered again as the hot records are added
+    tree_collection.forEach([this](const Tree &t){
+        uint32_t row=hot.add(t);
+        id_index.insert(&t, row);
+        double lat, lon;
+        t.get_position(lat, lon);
+        species_cells.add(lat, lon, hot[row].species);
+    });
+    if(rhs.hot.ordered_by_position())
+        order_by_position();
+    follow_relocations();
+}
+
+TreeCollection::TreeCollection(const TreeCollection &rhs, Share):
+    ITEM_NOT_FOUND(rhs.ITEM_NOT_FOUND),
+    tree_collection(rhs.tree_collection.share()), id_index(rhs.id_index),
+    hot(rhs.hot), density(rhs.density),
+    species_cells(rhs.species_cells.share()), species(rhs.species),
+    boro_map(rhs.boro_map){
+    //the shared nodes stay where rhs.id_index points for as long as this
+    //copy holds them
+    rep(i, 5) count_by_boro[i]=rhs.count_by_boro[i];
+}
+
+shared_ptr<const TreeCollection> TreeCollection::snapshot() const{
+    return shared_ptr<const TreeCollection>(new TreeCollection(*this,
+                                                               Share()));
+}
+
+//returns the index of a borough in boro_name, or 0 as add_tree() does
+int TreeCollection::boro_index(const string &name) const{
+    rep(i, 5)
+        if(boro_name[i]==name)
+            return i;
+    return 0;
+}
+
+//add_tree() moves trees out of nodes it shares with a snapshot; keep the id
+//index on the moved copies
+void TreeCollection::follow_relocations(){
+    tree_collection.onRelocate([this](const Tree *from, const Tree *to){
+        id_index.replace(from, to);
+    });
+}
 
-int TreeCollection::total_tree_count(){
+int TreeCollection::total_tree_count() const{
     int return_val=0;
     for(auto i:count_by_boro) return_val+=i;
     return return_val;
 }
 
-int TreeCollection::count_of_tree_species(const string &species_name){
-    return species.number_of_species();
+int TreeCollection::count_of_tree_species(const string &species_name) const{
+    //trees of one species are contiguous in the AvlTree, and ids are positive
+    return tree_collection.countRange(Tree(0, species_name),
+                                      Tree(0, species_name, 0, 0, INT_MAX));
 }
 
 int TreeCollection::count_of_tree_species_in_boro(const string &species_name,
-                                                  const string &_boro_name){
+                                                  const string &_boro_name)
+                                                  const{
     int return_val=0;
     rep(i, 5)
         if(boro_name[i]==_boro_name){
@@ -50,7 +100,7 @@ int TreeCollection::count_of_tree_species_in_boro(const string &species_name,
 }
 
 int TreeCollection::get_counts_of_trees_by_boro(const string &species_name,
-                                                boro tree_count[5]){
+                                                boro tree_count[5]) const{
     int return_val=0;
     auto it=boro_map.find(species_name);
     
@@ -63,7 +113,7 @@ int TreeCollection::get_counts_of_trees_by_boro(const string &species_name,
     return return_val;
 }
 
-int TreeCollection::count_of_trees_in_boro(const string &_boro_name){
+int TreeCollection::count_of_trees_in_boro(const string &_boro_name) const{
     int return_val=0;
     rep(i, 5){
         if(boro_name[i]==_boro_name)
@@ -73,31 +123,130 @@ int TreeCollection::count_of_trees_in_boro(const string &_boro_name){
 }
 
 int TreeCollection::add_tree(Tree &new_tree){
-    string new_name=new_tree.common_name();
+    //if tree is not found in AVLTree, add the tree to it and increment or add
+    // corresponding fields
+    if(id_index.find_same(new_tree)==nullptr){
+        count_added(*tree_collection.insert(new_tree));
+        return 1;
+    }
+    return 0;
+}
+
+int TreeCollection::add_tree(Tree &&new_tree){
+    if(id_index.find_same(new_tree)==nullptr){
+        count_added(*tree_collection.insert(move(new_tree)));
+        return 1;
+    }
+    return 0;
+}
+
+//indexes a tree add_tree() has just stored and counts it in its species and
+//borough; the names are read from the stored tree, which holds still until
+//the next insertion
+void TreeCollection::count_added(const Tree &stored){
+    const string &new_name=stored.common_name();
     array<int, 5> temp={};
     int new_boro=0;
-    rep(i, 5){        //set new_boro to index of boro name stored in new_tree
-        if(new_tree.borough_name()==boro_name[i])
+    rep(i, 5){        //set new_boro to index of boro name stored in the tree
+        if(stored.borough_name()==boro_name[i])
             new_boro=i;
     }
-    //if tree is not found in AVLTree, add the tree to it and increment or add
-    // corresponding fields
-    if(tree_collection.find(new_tree)==ITEM_NOT_FOUND){
-        count_by_boro[new_boro]++;
-        tree_collection.insert(new_tree);
-        if(species.add_species(new_name)){
-            temp[new_boro]++;
-            boro_map.insert(make_pair(new_name, temp));
+    count_by_boro[new_boro]++;
+    uint32_t row=hot.add(stored);
+    id_index.insert(&stored, row);
+    count_cells(stored, hot[row].species, true);
+    keep_order();
+    if(species.add_species(new_name)){
+        temp[new_boro]++;
+        boro_map.insert(make_pair(new_name, temp));
+    }
+    else{
+        for(const auto &i:boro_name){
+            if(i==stored.borough_name())
+                boro_map[new_name][new_boro]++;
         }
-        else{
-            for(auto i:boro_name){
-                if(i==new_tree.borough_name())
-                    boro_map[new_name][new_boro]++;
-            }
+    }
+}
+
+int TreeCollection::remove_trees(int id){
+    //copy the trees first; their slots move as the AvlTree changes
+    vector<Tree> found;
+    id_index.for_each_match(id, [&found](const Tree &t){ found.push_back(t); });
+    for(const auto &t:found){
+        string name=t.common_name();
+        int b=boro_index(t.borough_name());
+        const Tree *slot=id_index.find_same(t);
+        uint32_t row=id_index.row_of(slot);
+        id_index.erase(slot);
+        count_cells(t, hot[row].species, false);
+        uint32_t moved=hot.remove(row);
+        if(moved!=row)
+            id_index.set_row(hot[row].tree_id, moved, row);
+        keep_order();
+        tree_collection.remove(t);
+        count_by_boro[b]--;
+        auto it=boro_map.find(name);
+        if(it==boro_map.end())
+            continue;
+        it->second[b]--;
+        if(it->second==array<int, 5>{}){
+            boro_map.erase(it);
+            species.remove_species(name);
         }
-        return 1;
     }
-    return 0;
+    return found.size();
+}
+
+int TreeCollection::update_trees(int id, const string &field,
+                                 const string &value){
+    function<bool(Tree &)> set;
+    if(field=="status")
+        set=[&value](Tree &t){ return t.set_status(value); };
+    else if(field=="health")
+        set=[&value](Tree &t){ return t.set_health(value); };
+    else if(field=="dbh" && !value.empty() && value.size()<10 &&
+            value.find_first_not_of("0123456789")==string::npos)
+        set=[&value](Tree &t){ return t.set_diameter(stoi(value)); };
+    else
+        return -1;
+    Tree probe;
+    if(!set(probe))
+        return -1;
+    
+    vector<Tree> found;
+    id_index.for_each_match(id, [&found](const Tree &t){ found.push_back(t); });
+    for(const auto &t:found){
+        tree_collection.modify(t, set);
+        const Tree *slot=id_index.find_same(t);
+        hot.update(id_index.row_of(slot), *slot);
+    }
+    return found.size();
+}
+
+void TreeCollection::order_by_position(){
+    id_index.renumber(hot.order_by_position());
+}
+
+//counts a tree in or out of the cells of the density pyramid and of the
+//species cells
+void TreeCollection::count_cells(const Tree &t, uint32_t species, bool add){
+    double lat, lon;
+    t.get_position(lat, lon);
+    if(add){
+        density.add(lat, lon);
+        species_cells.add(lat, lon, species);
+    }
+    else{
+        density.remove(lat, lon);
+        species_cells.remove(lat, lon, species);
+    }
+}
+
+//orders the hot records again once enough trees were added or removed since
+//they were last ordered
+void TreeCollection::keep_order(){
+    if(hot.needs_reorder())
+        order_by_position();
 }
 
 void TreeCollection::print_all_species(ostream &out) const{
@@ -105,7 +254,53 @@ void TreeCollection::print_all_species(ostream &out) const{
 }
 
 void TreeCollection::print(ostream &out) const{
-    tree_collection.printTree();
+    if(tree_collection.isEmpty()){
+        out<<"Empty tree"<<'\n';
+        return;
+    }
+    print(out, 0, tree_collection.size());
+}
+
+void TreeCollection::print(ostream &out, int offset, int limit) const{
+    BufferedWriter writer(out);
+    tree_collection.forEach(offset, limit, [&writer](const Tree &t){
+        writer<<t;
+        writer.put('\n');
+    });
+}
+
+void TreeCollection::write_data_file(ostream &out) const{
+    BufferedWriter writer(out);
+    auto write_tree=[&writer](const Tree &t){
+        write_csv(writer, t);
+        writer.put('\n');
+    };
+    //the first tree of each id first, then the others in the order the
+    //index has them, so the index comes out the same
+    vector<int> shared_ids;
+    tree_collection.forEach([&](const Tree &t){
+        if(id_index.find(t.id())!=&t)
+            return;
+        write_tree(t);
+        int matches=0;
+        id_index.for_each_match(t.id(), [&matches](const Tree &){
+            matches++;
+        });
+        if(matches>1)
+            shared_ids.push_back(t.id());
+    });
+    for(int id:shared_ids){
+        bool first=true;
+        id_index.for_each_match(id, [&](const Tree &t){
+            if(!first)
+                write_tree(t);
+            first=false;
+        });
+    }
+}
+
+list<string> TreeCollection::get_all_species() const{
+    return species.get_all_species();
 }
 
 list<string> TreeCollection::get_matching_species(
@@ -113,28 +308,218 @@ list<string> TreeCollection::get_matching_species(
     return species.get_matching_species(species_name);
 }
 
+vector<const string *> TreeCollection::find_matching_species(
+    const string &species_name) const{
+    return species.find_matching_species(species_name);
+}
+
+vector<MemoryUsage> TreeCollection::memory_usage() const{
+    size_t strings=0;
+    tree_collection.forEach([&](const Tree &t){
+        strings+=t.heap_bytes();
+    });
+    size_t boro_bytes=heap_block(boro_map.bucket_count()*sizeof(void *));
+    for(const auto &entry:boro_map)
+        boro_bytes+=heap_block(HASH_NODE_OVERHEAD+sizeof(entry))+
+                    string_heap(entry.first);
+    return {{"tree nodes", tree_collection.size(), tree_collection.nodeBytes()},
+            {"tree strings", tree_collection.size(), strings},
+            {"species list", species.number_of_species(), species.heap_bytes()},
+            {"borough counts", (long)boro_map.size(), boro_bytes},
+            {"id index", (long)id_index.size(), id_index.heap_bytes()},
+            {"hot records", (long)hot.size(), hot.heap_bytes()},
+            {"density pyramid", (long)density.size(), density.heap_bytes()},
+            {"species cells", (long)species_cells.size(),
+             species_cells.heap_bytes()}};
+}
+
 list<string> TreeCollection::get_all_in_zipcode(int zipcode) const{
     list<string> result;
-    Tree target(zipcode);
-    
-    //get trees from Avl and insert the names to set
-    for(const auto &tree:tree_collection.getSameZip(target))
-        result.push_back(tree.common_name());
+    for(const Tree *tree:find_in_zipcode(zipcode))
+        result.push_back(tree->common_name());
     
     return result;
 }
 
+vector<const Tree *> TreeCollection::find_in_zipcode(int zipcode) const{
+    return trees_at(hot.find_rows([zipcode](const HotTree &h, uint32_t){
+        return h.zipcode==zipcode;
+    }));
+}
+
+const Tree *TreeCollection::tree_by_id(int id) const{
+    return id_index.find(id);
+}
+
 list<string> TreeCollection::get_all_near(double latitude, double longitude,
                                           double distance) const{
     list<string> result;
-    Tree center(0, "", latitude, longitude);
-    
-    for(auto tree:tree_collection.getCloseElem(center,distance))
-        result.push_back(tree.common_name());
+    for(const Tree *tree:find_near(latitude, longitude, distance))
+        result.push_back(tree->common_name());
     
     return result;
 }
 
+vector<const Tree *> TreeCollection::find_near(double latitude,
+                                               double longitude,
+                                               double distance) const{
+    //the exact records are within 22 degrees of the origin, so the bounds
+    //hold for a point within 90 degrees of it (see position_box)
+    GPS point(latitude, longitude);
+    double lat_span, lon_span;
+    distance_bounds(point, distance, lat_span, lon_span);
+    return find_where(position_box(latitude, longitude, lat_span, lon_span),
+                      [&point, distance](double lat, double lon){
+        return distance_between(point, GPS(lat, lon))<=distance;
+    });
+}
+
+vector<NearCount> TreeCollection::count_near(double latitude,
+                                             double longitude, double distance,
+                                             bool estimate) const{
+    NearCells near(latitude, longitude, distance, estimate);
+    vector<double> counts, errors;      // by species number
+    auto tally=[&](uint32_t species, double count, double error){
+        if(species>=counts.size()){
+            counts.resize(species+1, 0);
+            errors.resize(species+1, 0);
+        }
+        counts[species]+=count;
+        errors[species]+=error;
+    };
+    int x0, x1, y0, y1;
+    near.get_cells(x0, x1, y0, y1);
+    const uint32_t SIDE=SpeciesCells::SIDE;
+    for(int y=y0; y<=y1; y++)
+        species_cells.for_each_count(y*SIDE+x0, y*SIDE+x1,
+                                     [&](uint32_t cell, uint32_t s, long n){
+            double part=near.part(cell);
+            if(near.whole(cell))
+                tally(s, n, 0);
+            else if(estimate && !near.apart(cell))
+                tally(s, n*part, n*max(part, 1-part));
+        });
+    if(estimate && near.leaves_grid())
+        species_cells.for_each_count(SpeciesCells::OUTSIDE,
+                                     SpeciesCells::OUTSIDE,
+                                     [&](uint32_t, uint32_t s, long n){
+            tally(s, 0, n);
+        });
+    if(!estimate){
+        GPS point(latitude, longitude);
+        double lat_span, lon_span;
+        distance_bounds(point, distance, lat_span, lon_span);
+        for(uint32_t row:rows_where(position_box(latitude, longitude,
+                                                 lat_span, lon_span),
+                                    [&](double lat, double lon){
+            return !near.whole(SpeciesCells::cell_of(lat, lon)) &&
+                   distance_between(point, GPS(lat, lon))<=distance;
+        }))
+            tally(hot[row].species, 1, 0);
+    }
+
+    vector<NearCount> result;
+    for(uint32_t s=0; s<counts.size(); s++){
+        //the count is rounded, which adds at most half a tree to the error;
+        //the errors of the parts are floats, so allow for their rounding
+        long count=lround(counts[s]);
+        long error=(long)floor(errors[s]+0.5+1e-6);
+        if((count>0 || error>0) && !hot.species_name(s).empty())
+            result.push_back({&hot.species_name(s), count, error});
+    }
+    sort(result.begin(), result.end(), [](const NearCount &a,
+                                          const NearCount &b){
+        return compare_lower(*a.name, *b.name)<0 ||
+               (compare_lower(*a.name, *b.name)==0 && *a.name<*b.name);
+    });
+    return result;
+}
+
+vector<const Tree *> TreeCollection::find_in_box(double lat1, double lon1,
+                                                 double lat2, double lon2)
+const{
+    double lat_lo=min(lat1, lat2), lat_hi=max(lat1, lat2);
+    double lon_lo=min(lon1, lon2), lon_hi=max(lon1, lon2);
+    return find_where(position_range(lat_lo, lat_hi, lon_lo, lon_hi),
+                      [=](double lat, double lon){
+        return lat>=lat_lo && lat<=lat_hi && lon>=lon_lo && lon<=lon_hi;
+    });
+}
+
+vector<const Tree *> TreeCollection::find_in_polygon(const Polygon &polygon)
+const{
+    if(polygon.empty())
+        return {};
+    double lat_lo, lat_hi, lon_lo, lon_hi;
+    polygon.get_bounds(lat_lo, lat_hi, lon_lo, lon_hi);
+    return find_where(position_range(lat_lo, lat_hi, lon_lo, lon_hi),
+                      [&polygon](double lat, double lon){
+        return polygon.contains(lat, lon);
+    });
+}
+
+vector<HeatCell> TreeCollection::heatmap(int cell_m,
+                                         const string &species_name) const{
+    if(species_name.empty())
+        return density.cells(cell_m);
+    //the trees of a species are one run of the AVL tree
+    HeatLayer layer(cell_m);
+    tree_collection.forEach(tree_collection.rank(Tree(0, species_name)),
+                            count_of_tree_species(species_name),
+                            [&layer](const Tree &t){
+        double lat, lon;
+        t.get_position(lat, lon);
+        layer.add(lat, lon);
+    });
+    return layer.cells();
+}
+
+vector<Diversity> TreeCollection::diversity(int cell_m) const{
+    DiversityTally tally=hot.reduce(DiversityTally(cell_m),
+        [&](DiversityTally &part, const HotTree &h, uint32_t row){
+            if(hot.species_name(h.species).empty())
+                return;
+            if(cell_m==0){
+                part.add(h.zipcode, h.species);
+                return;
+            }
+            double lat, lon;
+            if(h.exact_position())
+                h.get_position(lat, lon);
+            else
+                id_index.find_row(h.tree_id, row)->get_position(lat, lon);
+            part.add(lat, lon, h.species);
+        },
+        [](DiversityTally a, const DiversityTally &b){
+            a.merge(b);
+            return a;
+        });
+    return tally.regions();
+}
+
+NearestStats TreeCollection::nearest_same_species(const string &species_name)
+const{
+    vector<pair<double, double>> positions;
+    tree_collection.forEach(tree_collection.rank(Tree(0, species_name)),
+                            count_of_tree_species(species_name),
+                            [&positions](const Tree &t){
+        double lat, lon;
+        t.get_position(lat, lon);
+        positions.push_back({lat, lon});
+    });
+    return nearest_stats(PointGrid(positions).all_nearest());
+}
+
+//the trees of hot records, found by their id and row
+vector<const Tree *> TreeCollection::trees_at(const vector<uint32_t> &rows)
+const{
+    vector<const Tree *> result;
+    result.reserve(rows.size());
+    for(uint32_t row:rows)
+        result.push_back(id_index.find_row(hot[row].tree_id, row));
+    return result;
+}
+
 
 
 
@@ -13,9 +13,25 @@ Modifications   : made by Keisuke Suzuki on Aug 06, 2019
 #include"../Tree/tree.h"
 #include "../TreeSpecies/tree_species.h"
 #include "../AVLTree/AvlTree.h"
+#include "../TreeIndex/tree_id_index.h"
+#include "../HotTrees/hot_trees.h"
+#include "../Polygon/polygon.h"
+#include "../Heatmap/density_pyramid.h"
+#include "../Heatmap/species_cells.h"
+#include "../Analytics/diversity.h"
+#include "../Analytics/nearest_neighbors.h"
 
 #define rep(i, n) for(int i=0;i<n;i++)
 
+/** NearCount is the number of trees of one species near a point, and how
+ *  far from the true number it may be
+ */
+struct NearCount{
+    const string *name;
+    long count;
+    long error;
+};
+
 class TreeCollection: public __TreeCollection{
     public:
     
@@ -23,24 +39,63 @@ class TreeCollection: public __TreeCollection{
     
     TreeCollection(TreeCollection &rhs);
     
-    int total_tree_count() override;
+    /** snapshot() returns a read-only copy of the collection that later
+     *  add_tree() calls do not change. The AVL tree is shared node by node
+     *  (see AvlTree::snapshot), the species list, borough counts, id
+     *  index and hot records are copied. Call it from the thread that adds
+     *  trees.
+     */
+    shared_ptr<const TreeCollection> snapshot() const;
     
-    int count_of_tree_species(const string &species_name) override;
+    int total_tree_count() const override;
+    
+    int count_of_tree_species(const string &species_name) const override;
     
     int count_of_tree_species_in_boro(const string &species_name,
-                                      const string &boro_name) override;
+                                      const string &boro_name) const override;
     
     int get_counts_of_trees_by_boro(const string &species_name,
-                                    boro tree_count[5]) override;
+                                    boro tree_count[5]) const override;
     
-    int count_of_trees_in_boro(const string &boro_name) override;
+    int count_of_trees_in_boro(const string &boro_name) const override;
     
     int add_tree(Tree &new_tree) override;
     
+    /** add_tree(t) with an rvalue moves t into the collection instead of
+     *  copying it. t is left as it was if the tree is already there.
+     */
+    int add_tree(Tree &&new_tree);
+    
+    /** remove_trees(id) removes every tree with census id, and the species
+     *  that no tree has any more
+     *  @return int the number of trees removed
+     */
+    int remove_trees(int id);
+    
+    /** update_trees(id,field,value) sets field, one of "status", "health"
+     *  or "dbh", to value in every tree with census id
+     *  @return int the number of trees changed, or -1 if field or value is
+     *          not valid
+     */
+    int update_trees(int id, const string &field, const string &value);
+    
+    /** order_by_position() puts the hot records in the order of a Hilbert
+     *  curve through the positions of the trees, so that the records
+     *  find_near() reads lie in a few runs of memory, and keeps them in
+     *  that order as trees are added and removed. The order of the AVL
+     *  tree, which print() and the results follow, does not change.
+     */
+    void order_by_position();
+    
     void print_all_species(ostream &out) const override;
     
     void print(ostream &out) const override;
     
+    /** print(out,offset,limit) prints at most limit trees on out, starting at
+     *  position offset of the order used by print(out).
+     */
+    void print(ostream &out, int offset, int limit) const;
+    
     list<string> get_matching_species(
         const string &species_name) const override;
     
@@ -49,10 +104,152 @@ class TreeCollection: public __TreeCollection{
     list<string> get_all_near(double latitude, double longitude,
                               double distance) const override;
     
+    /** find_matching_species(s), find_in_zipcode(z) and find_near(lat,lng,
+     *  dist) find what get_matching_species(), get_all_in_zipcode() and
+     *  get_all_near() do without copying: pointers to the species names and
+     *  to the trees themselves, in the same order. They stay valid until
+     *  the collection is changed; take them from a snapshot() to keep them
+     *  while trees are being added. The zip code and distance scans read
+     *  the HotTrees records, not the AVL tree; the distance scan only reads
+     *  the records in a box around the point once order_by_position() has
+     *  been called.
+     */
+    vector<const string *> find_matching_species(
+        const string &species_name) const;
+    
+    vector<const Tree *> find_in_zipcode(int zipcode) const;
+    
+    vector<const Tree *> find_near(double latitude, double longitude,
+                                   double distance) const;
+    
+    /** count_near(lat,lng,dist,estimate) counts the trees of each species
+     *  find_near(lat,lng,dist) finds, in the order of its species; names
+     *  that differ only in case are counted apart. The cells of
+     *  SpeciesCells that are wholly within dist add their counts, and only
+     *  the trees of the other cells are measured one by one, so the counts
+     *  are exact and error is 0. With estimate, no tree is measured: the
+     *  cells at the edge add their counts times the share of the cell
+     *  within dist, and error bounds how far count is from the true one.
+     */
+    vector<NearCount> count_near(double latitude, double longitude,
+                                 double distance, bool estimate) const;
+    
+    /** find_in_box(lat1,lon1,lat2,lon2) finds the trees whose position is in
+     *  the box with corners (lat1,lon1) and (lat2,lon2), edges included, in
+     *  the order of find_near()
+     */
+    vector<const Tree *> find_in_box(double lat1, double lon1, double lat2,
+                                     double lon2) const;
+    
+    /** find_in_polygon(polygon) finds the trees inside polygon, in the order
+     *  of find_near(). Only the hot records in the bounds of polygon are
+     *  read once order_by_position() has been called.
+     */
+    vector<const Tree *> find_in_polygon(const Polygon &polygon) const;
+    
+    /** heatmap(cell_m,species) counts the trees in each cell of cell_m
+     *  meters of the grid of DensityPyramid, and returns the cells that
+     *  hold any, row by row. The counts of all species come from the
+     *  pyramid; with a species name, the trees of that species, ignoring
+     *  case, are counted in one walk over their run of the AVL tree.
+     *  @pre DensityPyramid::valid_cell_size(cell_m)
+     */
+    vector<HeatCell> heatmap(int cell_m, const string &species_name="") const;
+    
+    /** diversity(cell_m) returns the Diversity of the trees of each zip
+     *  code if cell_m is 0, or of each cell of cell_m meters of the grid of
+     *  DensityPyramid, in the order of DiversityTally::regions(). Species
+     *  are told apart by their exact names, and trees without one are left
+     *  out. The hot records are counted in parallel, a part of the rows per
+     *  task.
+     *  @pre cell_m is 0 or DensityPyramid::valid_cell_size(cell_m)
+     */
+    vector<Diversity> diversity(int cell_m) const;
+    
+    /** nearest_same_species(s) returns, for the trees of species s, ignoring
+     *  case, the great_circle() distances from each to the nearest other
+     *  one, summed up. The trees are filed in a PointGrid and
+     *  searched in parallel.
+     */
+    NearestStats nearest_same_species(const string &species_name) const;
+    
+    /** write_data_file(out) writes every tree on out as a line of the data
+     *  file. Loading the lines again gives the same collection, including
+     *  which tree tree_by_id() returns for an id that several species share.
+     */
+    void write_data_file(ostream &out) const;
+    
+    /** get_all_species() returns all species names, sorted */
+    list<string> get_all_species() const;
+    
+    /** for_each_tree(offset,limit,f) calls f(const Tree&) on at most limit
+     *  trees, starting at position offset of the order print(out) uses
+     */
+    template <class Visitor>
+        void for_each_tree(int offset, int limit, Visitor f) const{
+            tree_collection.forEach(offset, limit, f);
+        }
+    
+    /** tree_by_id(id) returns the tree with census id, or nullptr if there is
+     *  none. If several species share the id, the first one added is returned.
+     */
+    const Tree *tree_by_id(int id) const;
+    
+    /** memory_usage() returns the heap memory of each part of the
+     *  collection: the AVL tree nodes, the strings of the trees, the
+     *  species list, the borough counts, the id index, the hot records, the
+     *  density pyramid and the species cells
+     */
+    vector<MemoryUsage> memory_usage() const;
+    
     private:
     
+    struct Share {};
+    
+    TreeCollection(const TreeCollection &rhs, Share);
+    
+    void follow_relocations();
+    
+    void count_added(const Tree &stored);
+    
+    void keep_order();
+    
+    vector<const Tree *> trees_at(const vector<uint32_t> &rows) const;
+    
+    /** rows_where(box,inside) finds the rows of the hot records in box for
+     *  which inside(lat,lon) is true, and find_where(box,inside) their
+     *  trees. A record whose coordinates are not exact gives the position
+     *  of its Tree, so that the answer never depends on the records.
+     */
+    template <class Inside>
+        vector<uint32_t> rows_where(const PositionBox &box,
+                                    Inside inside) const{
+            return hot.find_rows_in(box, [&](const HotTree &h, uint32_t row){
+                double lat, lon;
+                if(h.exact_position())
+                    h.get_position(lat, lon);
+                else
+                    id_index.find_row(h.tree_id, row)->get_position(lat, lon);
+                return inside(lat, lon);
+            });
+        }
+    
+    template <class Inside>
+        vector<const Tree *> find_where(const PositionBox &box,
+                                        Inside inside) const{
+            return trees_at(rows_where(box, inside));
+        }
+    
+    void count_cells(const Tree &t, uint32_t species, bool add);
+    
+    int boro_index(const string &name) const;
+    
     const Tree ITEM_NOT_FOUND;
     AvlTree<Tree> tree_collection;
+    TreeIdIndex id_index;
+    HotTrees hot;
+    DensityPyramid density;
+    SpeciesCells species_cells;
     TreeSpecies species;
     unordered_map<string, array<int, 5>> boro_map;
     int count_by_boro[5]={};
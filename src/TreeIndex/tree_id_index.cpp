@@ -0,0 +1,149 @@
+/**
+    tree_id_index.cpp
+    @version 1.0 10/19/26
+    Purpose: To Implement tree_id_index class
+    
+    License: Copyright (c) 2020 Keisuke Suzuki
+    	This program is free software: you can redistribute it and/or modify
+    	it under the terms of the GNU General Public License as published by
+    	the Free Software Foundation, either version 3 of the License, or
+    	(at your option) any later version.
+  
+    	This program is distributed in the hope that it will be useful,
+    	but WITHOUT ANY WARRANTY; without even the implied warranty of
+    	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    	GNU General Public License for more details
+*/
+
+#include "tree_id_index.h"
+#include "../Trace/trace.h"
+
+const size_t MIN_CAPACITY=1024;
+
+/****************************TreeIdIndex Class*********************************/
+
+TreeIdIndex::TreeIdIndex(): count(0), mask(0){}
+
+void TreeIdIndex::insert(const Tree *slot, uint32_t row){
+    if(2*(count+1)>table.size())
+        rehash(table.empty()?MIN_CAPACITY:2*table.size());
+    size_t i=bucket(slot->id());
+    while(table[i].slot!=nullptr)
+        i=(i+1)&mask;
+    table[i]={slot->id(), row, slot};
+    count++;
+}
+
+bool TreeIdIndex::erase(const Tree *slot){
+    if(table.empty()) return false;
+    size_t i=bucket(slot->id());
+    while(table[i].slot!=slot){
+        if(table[i].slot==nullptr) return false;
+        i=(i+1)&mask;
+    }
+    //backward shift: move the later entries of the run into the hole when
+    //their bucket is not after it, so no lookup ever stops early
+    size_t hole=i;
+    for(size_t j=(i+1)&mask; table[j].slot!=nullptr; j=(j+1)&mask)
+        if(((j-bucket(table[j].id))&mask)>=((j-hole)&mask)){
+            table[hole]=table[j];
+            hole=j;
+        }
+    table[hole]=Entry{0, 0, nullptr};
+    count--;
+    return true;
+}
+
+bool TreeIdIndex::replace(const Tree *from, const Tree *to){
+    if(table.empty()) return false;
+    for(size_t i=bucket(from->id()); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].slot==from){
+            table[i].slot=to;
+            return true;
+        }
+    return false;
+}
+
+long TreeIdIndex::row_of(const Tree *slot) const{
+    if(table.empty()) return -1;
+    for(size_t i=bucket(slot->id()); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].slot==slot) return table[i].row;
+    return -1;
+}
+
+bool TreeIdIndex::set_row(int id, uint32_t from, uint32_t to){
+    if(table.empty()) return false;
+    for(size_t i=bucket(id); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].id==id && table[i].row==from){
+            table[i].row=to;
+            return true;
+        }
+    return false;
+}
+
+void TreeIdIndex::renumber(const vector<uint32_t> &rows){
+    for(auto &e:table)
+        if(e.slot!=nullptr)
+            e.row=rows[e.row];
+}
+
+const Tree *TreeIdIndex::find_row(int id, uint32_t row) const{
+    if(table.empty()) return nullptr;
+    for(size_t i=bucket(id); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].id==id && table[i].row==row) return table[i].slot;
+    return nullptr;
+}
+
+const Tree *TreeIdIndex::find(int id) const{
+    if(table.empty()) return nullptr;
+    for(size_t i=bucket(id); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].id==id) return table[i].slot;
+    return nullptr;
+}
+
+const Tree *TreeIdIndex::find_same(const Tree &t) const{
+    if(table.empty()) return nullptr;
+    for(size_t i=bucket(t.id()); table[i].slot!=nullptr; i=(i+1)&mask)
+        if(table[i].id==t.id() && samename(*table[i].slot, t))
+            return table[i].slot;
+    return nullptr;
+}
+
+void TreeIdIndex::reserve(size_t n){
+    size_t capacity=MIN_CAPACITY;
+    while(capacity<2*n) capacity*=2;
+    if(capacity>table.size()) rehash(capacity);
+}
+
+size_t TreeIdIndex::size() const{
+    return count;
+}
+
+size_t TreeIdIndex::heap_bytes() const{
+    return heap_block(table.capacity()*sizeof(Entry));
+}
+
+void TreeIdIndex::clear(){
+    table.clear();
+    count=0;
+    mask=0;
+}
+
+//Fibonacci hashing; ids are dense integers, so spread them over the table
+size_t TreeIdIndex::bucket(int id) const{
+    return (size_t(uint32_t(id))*0x9E3779B97F4A7C15ull>>17)&mask;
+}
+
+void TreeIdIndex::rehash(size_t capacity){
+    TRACE_SPAN("index", "rehash id index");
+    vector<Entry> old(capacity, Entry{0, 0, nullptr});
+    old.swap(table);
+    mask=capacity-1;
+    for(const auto &e:old){
+        if(e.slot==nullptr) continue;
+        size_t i=bucket(e.id);
+        while(table[i].slot!=nullptr)
+            i=(i+1)&mask;
+        table[i]=e;
+    }
+}
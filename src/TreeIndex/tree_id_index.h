@@ -0,0 +1,116 @@
+/*******************************************************************************
+Title           : tree_id_index.h
+Created on      : Oct 19, 2026
+Description     : Interface of the TreeIdIndex class
+Purpose         : Maps a census tree_id to the slot where the Tree is stored
+                  so that trees can be found by id without walking the AVL
+                  tree, which is keyed on (species, id).
+*******************************************************************************/
+
+#ifndef SW2_TREE_ID_INDEX_H_
+#define SW2_TREE_ID_INDEX_H_
+
+#include "../Tree/tree.h"
+
+using namespace std;
+
+/** class TreeIdIndex is an open-addressing hash table from tree_id to the
+ *  address of the stored Tree. It uses linear probing over a power-of-two
+ *  table that is kept at most half full. Since the collection is keyed on
+ *  (species, id), one id may appear more than once; every such tree gets its
+ *  own entry in the same probe sequence.
+ *  Lookups never allocate. The slots are owned by the caller and must stay
+ *  valid for as long as they are in the index.
+ *  Each entry also keeps the row of the tree's record in HotTrees, which
+ *  fits in the padding of the entry.
+ */
+class TreeIdIndex{
+    public:
+    
+    TreeIdIndex();
+    
+    /** insert(slot,row) adds the tree stored at slot under its id.
+     *  @param const Tree* slot [in] address of a stored tree whose id is not 0
+     *  @param uint32_t    row  [in] the row of its hot record
+     */
+    void insert(const Tree *slot, uint32_t row=0);
+    
+    /** erase(slot) removes the entry of the tree stored at slot
+     *  @return bool false if slot was not in the index
+     */
+    bool erase(const Tree *slot);
+    
+    /** replace(from,to) makes the entry of the tree stored at from point
+     *  to to, where the same tree is stored now
+     *  @return bool false if from was not in the index
+     */
+    bool replace(const Tree *from, const Tree *to);
+    
+    /** row_of(slot) returns the row of the tree stored at slot, or -1 if
+     *  slot is not in the index
+     */
+    long row_of(const Tree *slot) const;
+    
+    /** set_row(id,from,to) makes the entry of id at row from say row to,
+     *  after the hot record has moved
+     *  @return bool false if there is no such entry
+     */
+    bool set_row(int id, uint32_t from, uint32_t to);
+    
+    /** renumber(rows) sets the row of every entry to rows[row], after the
+     *  hot records have been put in a new order
+     */
+    void renumber(const vector<uint32_t> &rows);
+    
+    /** find_row(id,row) returns the tree with the given id whose hot record
+     *  is at row, or nullptr if there is none
+     */
+    const Tree *find_row(int id, uint32_t row) const;
+    
+    /** find(id) returns the first tree stored with the given id
+     *  @return const Tree* the stored tree or nullptr if there is none
+     */
+    const Tree *find(int id) const;
+    
+    /** find_same(t) returns the stored tree with the same key pair as t
+     *  @return const Tree* the stored tree equal to t or nullptr
+     */
+    const Tree *find_same(const Tree &t) const;
+    
+    /** for_each_match(id,f) calls f(const Tree&) on every tree with this id
+     */
+    template <class Visitor>
+        void for_each_match(int id, Visitor f) const{
+            if(table.empty()) return;
+            for(size_t i=bucket(id); table[i].slot!=nullptr; i=(i+1)&mask)
+                if(table[i].id==id) f(*table[i].slot);
+        }
+    
+    /** reserve(n) makes room for n trees without rehashing */
+    void reserve(size_t n);
+    
+    size_t size() const;
+    
+    /** heap_bytes() returns the heap memory of the table */
+    size_t heap_bytes() const;
+    
+    void clear();
+    
+    private:
+    
+    struct Entry{
+        int id;
+        uint32_t row;
+        const Tree *slot;
+    };
+    
+    vector<Entry> table;
+    size_t count;
+    size_t mask;
+    
+    size_t bucket(int id) const;
+    
+    void rehash(size_t capacity);
+};
+
+#endif //SW2_TREE_ID_INDEX_H_
@@ -42,12 +42,44 @@ TreeSpecies::TreeSpecies() = default;
 
 void TreeSpecies::print_all_species( ostream &out ) const
 {
+    BufferedWriter writer(out);
     for(const auto &i:species_map)
     {
-        out << i.first << '\n';
+        writer.write(i.first).put('\n');
     }
 }
 
+list <string> TreeSpecies::get_all_species() const
+{
+    list <string> result;
+    for(const auto &i:species_map)
+    {
+        result.push_back(i.first);
+    }
+    return result;
+}
+
+bool TreeSpecies::remove_species( const string &species )
+{
+    return species_map.erase(species) > 0;
+}
+
+size_t TreeSpecies::heap_bytes() const
+{
+    size_t bytes = 0;
+    for(const auto &i:species_map)
+    {
+        bytes += heap_block(MAP_NODE_OVERHEAD + sizeof(i)) +
+                 string_heap(i.first);
+        for(const auto &word:i.second)
+        {
+            bytes += heap_block(LIST_NODE_OVERHEAD + sizeof(word)) +
+                     string_heap(word);
+        }
+    }
+    return bytes;
+}
+
 int TreeSpecies::number_of_species() const
 {
     return species_map.size();
@@ -55,6 +87,11 @@ int TreeSpecies::number_of_species() const
 
 int TreeSpecies::add_species( const string &species )
 {
+    //most trees are of a species that is already listed; do not split its
+    //name again only to find that out
+    if(species_map.find(species) != species_map.end())
+        return 0;
+    
     string temp;
     list <string> _temp;
     
@@ -76,24 +113,34 @@ int TreeSpecies::add_species( const string &species )
                 _temp.push_back(temp);
         }
     }
-    auto it = species_map.find(species);
-    species_map.insert(make_pair(species, _temp));
+    species_map.insert(make_pair(species, move(_temp)));
     
-    return it == species_map.end();
+    return 1;
 }
 
 list <string> TreeSpecies::get_matching_species(
 const string &partial_name ) const
+{
+    list <string> result;
+    for(const string *name:find_matching_species(partial_name))
+    {
+        result.push_back(*name);
+    }
+    return result;
+}
+
+vector <const string *> TreeSpecies::find_matching_species(
+const string &partial_name ) const
 {
     
-    set <string> result;
+    vector <const string *> result;
     list <string> _partial_name;
     list<string>::const_iterator p_it;
     stringstream ss(partial_name);
     string temp;
     
     if(partial_name.empty())
-        return list<string>(result.begin(), result.end());
+        return result;
     
     //store input words in partial name excluding '-'
     while(getline(ss, temp, '-'))
@@ -131,7 +178,8 @@ const string &partial_name ) const
                 break;
             }
         }
-        if(match) result.insert(map_elem.first);
+        //the map is sorted, so the names come out sorted and once each
+        if(match) result.push_back(&map_elem.first);
     }
-    return list<string>(result.begin(), result.end());
+    return result;
 }
\ No newline at end of file
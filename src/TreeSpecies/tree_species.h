@@ -34,6 +34,28 @@ class TreeSpecies: __TreeSpecies{
      * function should not contain any duplicate names and may be empty.
      */
     list<string> get_matching_species(const string &partial_name)const override;
+    
+    /** find_matching_species(s) returns the same species as
+     *  get_matching_species(s), as pointers to the names kept in the list,
+     *  without copying them. They stay valid until the species is removed.
+     */
+    vector<const string *> find_matching_species(
+        const string &partial_name) const;
+    
+    /** get_all_species() returns all species names in the order
+     *  print_all_species() prints them
+     */
+    list<string> get_all_species() const;
+    
+    /** remove_species(s) removes species s, once no tree has it any more
+     *  @return bool false if s was not in the list
+     */
+    bool remove_species(const string &species);
+    
+    /** heap_bytes() returns the heap memory of species_map: its nodes, the
+     *  names and the lists of words with their strings
+     */
+    size_t heap_bytes() const;
     private:
     
     /** specie_map is a map that has specie common name as a first, and list
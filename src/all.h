@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <new>
+#include <memory>
 #include <typeinfo>
 #include <exception>
 #include <initializer_list>
@@ -13,11 +14,16 @@
 #include <cerrno>
 #include <system_error>
 #include <string>
+#include <cstring>
 
 #if __has_include(<string_view>)
 #   include <string_view>
 #endif
 
+#if __has_include(<charconv>)
+#   include <charconv>
+#endif
+
 #include <array>
 #include <deque>
 #include <forward_list>
@@ -30,6 +36,7 @@
 #include <queue>
 #include <stack>
 #include <iterator>
+#include <functional>
 #include <algorithm>
 #include <cfenv>
 #include <random>
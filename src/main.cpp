@@ -23,26 +23,64 @@
 #include "Tree/tree.h"
 #include "TreeCollection/tree_collection.h"
 #include "Command/command.h"
+#include "Executor/command_executor.h"
+#include "ResultWriter/result_writer.h"
+#include "Options/options.h"
+#include "Server/query_server.h"
+#include "Executor/parallel_runner.h"
+#include "Loader/tree_loader.h"
+#include "Loader/progressive_loader.h"
+#include "ChangeLog/change_log.h"
+#include "Scheduler/task_scheduler.h"
+#include "Stats/run_stats.h"
+#include "Memory/memory_report.h"
+#include "Trace/trace.h"
 
 using namespace std;
 
-const string boro_name[5] = {
-"Bronx", "Manhattan", "Brooklyn", "Queens", "Staten Island"
-};
-
-class comma_numpunct: public std::numpunct<char>
+/** run_progressive() runs the command file while loader is still loading.
+ *  Each command runs against the latest snapshot, after waiting for the
+ *  part of the file given by --wait-for; commands that change the
+ *  collection wait for all of it.
+ */
+int run_progressive(TreeCollection &trees, ProgressiveLoader &loader,
+                    const Options &options, ifstream &commandfile)
 {
-    protected:
-    char do_thousands_sep() const override
-    {
-        return ',';
-    }
+    Command command;
+    unique_ptr<__ResultWriter> writer = make_result_writer(options.format,
+                                                           cout);
     
-    string do_grouping() const override
+    loader.wait_for(options.wait_for);
+    while(! commandfile.eof())
     {
-        return "\03";
+        if(! command.get_next(commandfile))
+        {
+            if(! commandfile.eof())
+            {
+                cerr << "Error getting command.\n";
+                continue;
+            }
+            else
+                return 1;
+        }
+        shared_ptr<const LoadedTrees> loaded =
+            changes_collection(command.type_of()) ? loader.wait_for(1)
+                                                  : loader.latest();
+        if(loaded->complete)
+        {
+            // the loader is done with the collection; use it directly so
+            // that changes are seen by the commands after them
+            loader.finish();
+            CommandExecutor executor(trees, nullptr, loaded->rows, true);
+            executor.execute(command, *writer);
+            continue;
+        }
+        CommandExecutor executor(*loaded->trees, loaded->rows, false);
+        executor.execute(command, *writer);
     }
-};
+    commandfile.close();
+    return 0;
+}
 
 int main( int argc, char *argv[] )
 {
@@ -50,73 +88,111 @@ int main( int argc, char *argv[] )
     ifstream inputfile;
     ifstream commandfile;
     TreeCollection NYCTrees;
-    string tree_line;
-    list<string> matching_species;
-    string input_string;
-    boro tree_counts_by_borough[5] = { { 0, "Bronx" },
-                                       { 0, "Manhattan" },
-                                       { 0, "Brooklyn" },
-                                       { 0, "Queens" },
-                                       { 0, "Staten Island" } };
     Command command;
-    string treename;
-    int zipcode;
-    double latitude, longitude, distance;
-    bool result;
-    string prev;
-    list<string>::iterator it;
-    int freq;
-    if(argc < 3)
+    Options options;
+    
+    if(! parse_options(argc, argv, options))
     {
-        cerr << "\n Usage: " << argv[0] << " input_file  command_file" << endl;
+        usage(argv[0]);
         exit(1);
     }
     
-    inputfile.open(argv[1]);
-    if(inputfile.fail())
+    if(options.jobs > 1)
+        TaskScheduler::set_default_threads(options.jobs);
+    
+    // print the timings and the memory report, and write the trace, on the
+    // way out of main()
+    StatsReport report(options.stats, cerr, options.counters);
+    TraceReport trace(options.trace_file);
+    MemoryReport memory(NYCTrees, options.mem_report, cerr);
+    
+    if(! options.client_socket.empty())
     {
-        cerr << "Could not open data file " << argv[1] << " for reading"
-             << endl;
-        exit(1);
+        commandfile.open(options.command_file);
+        if(commandfile.fail())
+        {
+            cerr << "Could not open command file " << options.command_file
+                 << " for reading" << endl;
+            exit(1);
+        }
+        return run_client(options.client_socket, commandfile, cout) ? 0 : 1;
     }
     
-    commandfile.open(argv[2]);
-    if(commandfile.fail())
+    // the snapshot of the change log, once there is one, replaces the
+    // original data file
+    ChangeLog changelog(NYCTrees, options.log_file, options.compact_every);
+    if(! options.log_file.empty() &&
+       ifstream(changelog.snapshot_path()).good())
+        options.input_file = changelog.snapshot_path();
+    
+    inputfile.open(options.input_file);
+    if(inputfile.fail())
     {
-        cerr << "Could not open command file " << argv[2] << " for reading"
-             << endl;
+        cerr << "Could not open data file " << options.input_file
+             << " for reading" << endl;
         exit(1);
     }
     
-    int count = 0;
-    int numtrees = 0;
-    int line = 1;
-    while(getline(inputfile, tree_line))
+    if(options.serve_socket.empty())
     {
-        // Create a tree to insert into the TreeCollection
-        Tree temp_tree(tree_line);
-        if(0 != temp_tree.id())
+        commandfile.open(options.command_file);
+        if(commandfile.fail())
         {
-            numtrees += NYCTrees.add_tree(temp_tree);
-            count ++;
+            cerr << "Could not open command file " << options.command_file
+                 << " for reading" << endl;
+            exit(1);
         }
-        else
+    }
+    
+    // the progressive loader keeps the order as it adds the trees; the
+    // others order them once they are all loaded
+    if(options.spatial_order && options.progressive > 0)
+        NYCTrees.order_by_position();
+    
+    if(options.progressive > 0)
+    {
+        inputfile.close();
+        ProgressiveLoader loader(NYCTrees, options.progressive);
+        if(! loader.start(options.input_file))
         {
-            cerr << "bad data on line " << line << endl;
+            cerr << "Could not open data file " << options.input_file
+                 << " for reading" << endl;
+            exit(1);
         }
-        line ++;
+        return run_progressive(NYCTrees, loader, options, commandfile);
     }
     
+    TreeLoader loader(NYCTrees);
+    loader.load(inputfile);
+    
     inputfile.close();
     
-    // Create a locale to use that puts commas in long integers
-    locale comma_locale(std::locale(), new comma_numpunct());
+    if(options.spatial_order)
+        NYCTrees.order_by_position();
     
-    // Save the original locale for when we do not want those commas
-    locale orig_locale = cout.getloc();
+    ChangeLog *log = nullptr;
+    if(! options.log_file.empty())
+    {
+        if(changelog.replay() < 0)
+            exit(1);
+        log = &changelog;
+    }
+    
+    if(! options.serve_socket.empty())
+    {
+        QueryServer server(NYCTrees, options.format, options.threads);
+        return server.serve(options.serve_socket) ? 0 : 1;
+    }
     
-    // tell cout to use our new locale.
-    //cout.imbue(comma_locale);
+    if(options.jobs > 1)
+    {
+        ParallelRunner runner(NYCTrees, options.format, log);
+        return runner.run(commandfile, cout);
+    }
+    
+    CommandExecutor executor(NYCTrees, log);
+    unique_ptr<__ResultWriter> writer = make_result_writer(options.format,
+                                                           cout);
     
     while(! commandfile.eof())
     {
@@ -130,151 +206,7 @@ int main( int argc, char *argv[] )
             else
                 return 1;
         }
-        command.get_args(treename, zipcode, latitude, longitude,
-                         distance, result);
-        
-        cout << "Command: ";
-        switch(command.type_of())
-        {
-            case tree_info_cmmd:
-                // tell cout to use our new locale.
-                cout.imbue(comma_locale);
-                
-                cout << "tree_info " << treename << endl;
-                matching_species = NYCTrees.get_matching_species(treename);
-                if(matching_species.empty())
-                    cout << "There are no matching species.\n";
-                else
-                {
-                    cout << "The matching species are: \n";
-                    for(auto &matching_specie : matching_species)
-                    {
-                        cout << "\t" << matching_specie << endl;
-                    }
-                    cout << "Popularity in the city:\n";
-                    
-                    int total = 0;
-                    for(auto &i:tree_counts_by_borough)
-                    {
-                        i.count = 0;
-                    }
-                    
-                    // Get total numbers of all matching species by boro
-                    for(auto &matching_specie:matching_species)
-                    {
-                        total += NYCTrees.get_counts_of_trees_by_boro(
-                        matching_specie,
-                        tree_counts_by_borough);
-                    }
-                    
-                    // Print NYC total first, then print by boro
-                    double percentage;
-                    int total_in_city = NYCTrees.total_tree_count();
-                    percentage =
-                    total_in_city > 0 ? (double) 100.00 * total / total_in_city
-                                      : 0;
-                    cout << "\t"
-                         << left << setw(15) << "New York City"
-                         << right << setw(12) << total
-                         << "  (" << right << setw(12) << total_in_city << ")"
-                         << right << setw(12) << fixed << setprecision(2)
-                         << percentage << "%"
-                         << endl;
-                    
-                    for(int i = 0; i < 5; i ++)
-                    {
-                        int boro_total = NYCTrees.count_of_trees_in_boro(
-                        boro_name[i]);
-                        percentage = boro_total > 0 ?
-                                     (double) 100.00 *
-                                     tree_counts_by_borough[i].count /
-                                     boro_total : 0;
-                        cout << "\t"
-                             << left << setw(15) << boro_name[i]
-                             << right << setw(12)
-                             << tree_counts_by_borough[i].count
-                             << "  (" << right << setw(12) << boro_total << ")"
-                             << right << setw(12) << fixed << setprecision(2)
-                             << percentage << "%"
-                             << endl;
-                    }
-                }
-                cout.imbue(orig_locale);
-                break;
-            
-            case listall_names_cmmd:cout << "listall_names" << endl;
-                NYCTrees.print_all_species(cout);
-                break;
-            
-            case print_all_cmmd:cout << "print_all" << endl;
-                NYCTrees.print(cout);
-                break;
-            
-            case remove_stumps_cmmd:cout << "remove_stumps" << endl;
-                
-                break;
-            case list_near_cmmd:
-                cout << "list_near " << fixed << setprecision(6) << latitude
-                     << " "
-                     << longitude << " " << distance << endl;
-                cout.imbue(comma_locale);
-                matching_species = NYCTrees.get_all_near(latitude, longitude,
-                                                         distance);
-                it = matching_species.begin();
-                freq = 0;
-                prev = "";
-                while(it != matching_species.end())
-                {
-                    if(prev == *it)
-                        freq ++;
-                    else
-                    {
-                        if(prev != "")
-                            cout << "\t"
-                                 << left << setw(22) << prev
-                                 << right << setw(8) << freq << endl;
-                        freq = 1;
-                        prev = *it;
-                    }
-                    it ++;
-                }
-                if(prev != "")
-                    cout << "\t" << left << setw(22) << prev
-                         << right << setw(8) << freq << endl;
-                cout.imbue(orig_locale);
-                break;
-            
-            case listall_inzip_cmmd:cout << "listall_inzip " << zipcode << endl;
-                cout.imbue(comma_locale);
-                matching_species = NYCTrees.get_all_in_zipcode(zipcode);
-                it = matching_species.begin();
-                freq = 0;
-                prev = "";
-                while(it != matching_species.end())
-                {
-                    if(prev == *it)
-                        freq ++;
-                    else
-                    {
-                        if(prev != "")
-                            cout << "\t"
-                                 << left << setw(22) << prev
-                                 << right << setw(8) << freq << endl;
-                        freq = 1;
-                        prev = *it;
-                    }
-                    it ++;
-                }
-                if(prev != "")
-                    cout << "\t" << left << setw(22) << prev
-                         << right << setw(8) << freq << endl;
-                cout.imbue(orig_locale);
-                break;
-            case bad_cmmd:cerr << "bad command" << endl;
-                break;
-            default:break;
-        }
-        cout << endl;
+        executor.execute(command, *writer);
     }
     commandfile.close();
     return 0;